@@ -0,0 +1,26 @@
+#include "bench.h"
+
+static const size_t iterations = 1000000;
+
+static const size_t length = 10000;
+
+int
+main (int argc, char *argv[]) {
+  Bench bench(argc, argv);
+
+  auto &runtime = bench.runtime;
+
+  jsi::Scope scope(runtime);
+
+  auto array = jsi::Array(runtime, length);
+
+  bench.run("array-index/set", iterations, [&] (size_t i) {
+    array.setValueAtIndex(runtime, i % length, static_cast<int>(i));
+  });
+
+  bench.run("array-index/get", iterations, [&] (size_t i) {
+    array.getValueAtIndex(runtime, i % length).getNumber();
+  });
+
+  bench.report();
+}
@@ -0,0 +1,241 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <new>
+#include <string>
+#include <vector>
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <js.h>
+
+// Count the calls jsi.h makes into the engine by routing each of them
+// through a macro that bumps a counter. js.h is included first so that its
+// declarations are left alone; the macros don't expand recursively, so each
+// one still calls the real function.
+static size_t bench_engine_calls = 0;
+
+#define js_add_type_tag(...) (bench_engine_calls++, ::js_add_type_tag(__VA_ARGS__))
+#define js_call_function(...) (bench_engine_calls++, ::js_call_function(__VA_ARGS__))
+#define js_check_type_tag(...) (bench_engine_calls++, ::js_check_type_tag(__VA_ARGS__))
+#define js_close_handle_scope(...) (bench_engine_calls++, ::js_close_handle_scope(__VA_ARGS__))
+#define js_coerce_to_string(...) (bench_engine_calls++, ::js_coerce_to_string(__VA_ARGS__))
+#define js_create_array(...) (bench_engine_calls++, ::js_create_array(__VA_ARGS__))
+#define js_create_array_with_length(...) (bench_engine_calls++, ::js_create_array_with_length(__VA_ARGS__))
+#define js_create_bigint_int64(...) (bench_engine_calls++, ::js_create_bigint_int64(__VA_ARGS__))
+#define js_create_bigint_uint64(...) (bench_engine_calls++, ::js_create_bigint_uint64(__VA_ARGS__))
+#define js_create_delegate(...) (bench_engine_calls++, ::js_create_delegate(__VA_ARGS__))
+#define js_create_double(...) (bench_engine_calls++, ::js_create_double(__VA_ARGS__))
+#define js_create_env(...) (bench_engine_calls++, ::js_create_env(__VA_ARGS__))
+#define js_create_external_arraybuffer(...) (bench_engine_calls++, ::js_create_external_arraybuffer(__VA_ARGS__))
+#define js_create_function(...) (bench_engine_calls++, ::js_create_function(__VA_ARGS__))
+#define js_create_int32(...) (bench_engine_calls++, ::js_create_int32(__VA_ARGS__))
+#define js_create_int64(...) (bench_engine_calls++, ::js_create_int64(__VA_ARGS__))
+#define js_create_object(...) (bench_engine_calls++, ::js_create_object(__VA_ARGS__))
+#define js_create_platform(...) (bench_engine_calls++, ::js_create_platform(__VA_ARGS__))
+#define js_create_reference(...) (bench_engine_calls++, ::js_create_reference(__VA_ARGS__))
+#define js_create_string_utf8(...) (bench_engine_calls++, ::js_create_string_utf8(__VA_ARGS__))
+#define js_create_typed_function(...) (bench_engine_calls++, ::js_create_typed_function(__VA_ARGS__))
+#define js_create_uint32(...) (bench_engine_calls++, ::js_create_uint32(__VA_ARGS__))
+#define js_define_class(...) (bench_engine_calls++, ::js_define_class(__VA_ARGS__))
+#define js_delete_reference(...) (bench_engine_calls++, ::js_delete_reference(__VA_ARGS__))
+#define js_destroy_env(...) (bench_engine_calls++, ::js_destroy_env(__VA_ARGS__))
+#define js_destroy_platform(...) (bench_engine_calls++, ::js_destroy_platform(__VA_ARGS__))
+#define js_get_and_clear_last_exception(...) (bench_engine_calls++, ::js_get_and_clear_last_exception(__VA_ARGS__))
+#define js_get_array_elements(...) (bench_engine_calls++, ::js_get_array_elements(__VA_ARGS__))
+#define js_get_array_length(...) (bench_engine_calls++, ::js_get_array_length(__VA_ARGS__))
+#define js_get_arraybuffer_info(...) (bench_engine_calls++, ::js_get_arraybuffer_info(__VA_ARGS__))
+#define js_get_boolean(...) (bench_engine_calls++, ::js_get_boolean(__VA_ARGS__))
+#define js_get_callback_info(...) (bench_engine_calls++, ::js_get_callback_info(__VA_ARGS__))
+#define js_get_element(...) (bench_engine_calls++, ::js_get_element(__VA_ARGS__))
+#define js_get_global(...) (bench_engine_calls++, ::js_get_global(__VA_ARGS__))
+#define js_get_null(...) (bench_engine_calls++, ::js_get_null(__VA_ARGS__))
+#define js_get_platform_identifier(...) (bench_engine_calls++, ::js_get_platform_identifier(__VA_ARGS__))
+#define js_get_property(...) (bench_engine_calls++, ::js_get_property(__VA_ARGS__))
+#define js_get_property_names(...) (bench_engine_calls++, ::js_get_property_names(__VA_ARGS__))
+#define js_get_reference_value(...) (bench_engine_calls++, ::js_get_reference_value(__VA_ARGS__))
+#define js_get_typed_callback_info(...) (bench_engine_calls++, ::js_get_typed_callback_info(__VA_ARGS__))
+#define js_get_undefined(...) (bench_engine_calls++, ::js_get_undefined(__VA_ARGS__))
+#define js_get_value_bigint_int64(...) (bench_engine_calls++, ::js_get_value_bigint_int64(__VA_ARGS__))
+#define js_get_value_bigint_uint64(...) (bench_engine_calls++, ::js_get_value_bigint_uint64(__VA_ARGS__))
+#define js_get_value_bool(...) (bench_engine_calls++, ::js_get_value_bool(__VA_ARGS__))
+#define js_get_value_double(...) (bench_engine_calls++, ::js_get_value_double(__VA_ARGS__))
+#define js_get_value_int32(...) (bench_engine_calls++, ::js_get_value_int32(__VA_ARGS__))
+#define js_get_value_int64(...) (bench_engine_calls++, ::js_get_value_int64(__VA_ARGS__))
+#define js_get_value_string_utf8(...) (bench_engine_calls++, ::js_get_value_string_utf8(__VA_ARGS__))
+#define js_get_value_uint32(...) (bench_engine_calls++, ::js_get_value_uint32(__VA_ARGS__))
+#define js_has_property(...) (bench_engine_calls++, ::js_has_property(__VA_ARGS__))
+#define js_instanceof(...) (bench_engine_calls++, ::js_instanceof(__VA_ARGS__))
+#define js_is_array(...) (bench_engine_calls++, ::js_is_array(__VA_ARGS__))
+#define js_is_arraybuffer(...) (bench_engine_calls++, ::js_is_arraybuffer(__VA_ARGS__))
+#define js_is_function(...) (bench_engine_calls++, ::js_is_function(__VA_ARGS__))
+#define js_new_instance(...) (bench_engine_calls++, ::js_new_instance(__VA_ARGS__))
+#define js_open_handle_scope(...) (bench_engine_calls++, ::js_open_handle_scope(__VA_ARGS__))
+#define js_run_script(...) (bench_engine_calls++, ::js_run_script(__VA_ARGS__))
+#define js_set_array_elements(...) (bench_engine_calls++, ::js_set_array_elements(__VA_ARGS__))
+#define js_set_element(...) (bench_engine_calls++, ::js_set_element(__VA_ARGS__))
+#define js_set_property(...) (bench_engine_calls++, ::js_set_property(__VA_ARGS__))
+#define js_strict_equals(...) (bench_engine_calls++, ::js_strict_equals(__VA_ARGS__))
+#define js_throw(...) (bench_engine_calls++, ::js_throw(__VA_ARGS__))
+#define js_throw_error(...) (bench_engine_calls++, ::js_throw_error(__VA_ARGS__))
+#define js_throw_type_error(...) (bench_engine_calls++, ::js_throw_type_error(__VA_ARGS__))
+#define js_typeof(...) (bench_engine_calls++, ::js_typeof(__VA_ARGS__))
+#define js_unwrap(...) (bench_engine_calls++, ::js_unwrap(__VA_ARGS__))
+#define js_wrap(...) (bench_engine_calls++, ::js_wrap(__VA_ARGS__))
+
+#include "../include/jsi.h"
+
+static std::atomic<size_t> bench_allocations = 0;
+
+void *
+operator new(size_t size) {
+  bench_allocations.fetch_add(1, std::memory_order_relaxed);
+
+  void *ptr = malloc(size == 0 ? 1 : size);
+
+  if (ptr == nullptr) throw std::bad_alloc();
+
+  return ptr;
+}
+
+void
+operator delete(void *ptr) noexcept {
+  free(ptr);
+}
+
+void
+operator delete(void *ptr, size_t) noexcept {
+  free(ptr);
+}
+
+struct Bench {
+  JSIPlatform platform;
+  JSIRuntime runtime;
+
+  Bench(int argc, char *argv[]) : runtime(platform), iterations(argc > 1 ? strtoul(argv[1], nullptr, 10) : 0) {}
+
+  Bench(const Bench &) = delete;
+
+  Bench &
+  operator=(const Bench &) = delete;
+
+  // Time `iterations` calls of `fn`, opening a fresh jsi::Scope every
+  // `batch` calls so that scope-local values are bounded without paying for
+  // a scope on every operation. Passing an iteration count on the command
+  // line overrides the default of every benchmark.
+  template <typename F>
+  void
+  run(const char *name, size_t iterations, F fn) {
+    if (this->iterations) iterations = this->iterations;
+
+    auto allocations = bench_allocations.load(std::memory_order_relaxed);
+
+    auto engine_calls = bench_engine_calls;
+
+    auto start = std::chrono::steady_clock::now();
+
+    for (size_t i = 0; i < iterations;) {
+      jsi::Scope scope(runtime);
+
+      for (size_t end = std::min(i + batch, iterations); i < end; i++) {
+        fn(i);
+      }
+    }
+
+    auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start);
+
+    record(name, iterations, elapsed.count(), bench_allocations.load(std::memory_order_relaxed) - allocations, bench_engine_calls - engine_calls);
+  }
+
+  // Like run(), but only time `fn` itself, which is passed the product of
+  // `setup` for the whole batch. Used for costs that cannot be isolated per
+  // operation, such as destroying values.
+  template <typename S, typename F>
+  void
+  run(const char *name, size_t iterations, S setup, F fn) {
+    if (this->iterations) iterations = this->iterations;
+
+    size_t allocations = 0;
+    size_t engine_calls = 0;
+
+    double elapsed = 0;
+
+    for (size_t i = 0; i < iterations;) {
+      jsi::Scope scope(runtime);
+
+      size_t n = std::min(batch, iterations - i);
+
+      auto state = setup(n);
+
+      auto before = bench_allocations.load(std::memory_order_relaxed);
+
+      auto calls = bench_engine_calls;
+
+      auto start = std::chrono::steady_clock::now();
+
+      fn(state);
+
+      elapsed += std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+      allocations += bench_allocations.load(std::memory_order_relaxed) - before;
+
+      engine_calls += bench_engine_calls - calls;
+
+      i += n;
+    }
+
+    record(name, iterations, elapsed, allocations, engine_calls);
+  }
+
+  // Print the collected results as a single JSON document on stdout.
+  void
+  report() {
+    auto pool = runtime.pointerValueStats();
+
+    printf("{\"benchmarks\":[");
+
+    for (size_t i = 0; i < results.size(); i++) {
+      auto &result = results[i];
+
+      printf(
+        "%s{\"name\":\"%s\",\"iterations\":%zu,\"ns_per_op\":%.2f,\"allocations_per_op\":%.3f,\"engine_calls_per_op\":%.3f}",
+        i == 0 ? "" : ",",
+        result.name.c_str(),
+        result.iterations,
+        result.ns / result.iterations,
+        static_cast<double>(result.allocations) / result.iterations,
+        static_cast<double>(result.engine_calls) / result.iterations
+      );
+    }
+
+    printf(
+      "],\"pointer_values\":{\"hits\":%zu,\"misses\":%zu,\"slabs\":%zu,\"live\":%zu}}\n",
+      pool.hits,
+      pool.misses,
+      pool.slabs,
+      pool.live
+    );
+  }
+
+private:
+  struct Result {
+    std::string name;
+    size_t iterations;
+    double ns;
+    size_t allocations;
+    size_t engine_calls;
+  };
+
+  static constexpr size_t batch = 1000;
+
+  size_t iterations;
+
+  std::vector<Result> results;
+
+  void
+  record(const char *name, size_t iterations, double ns, size_t allocations, size_t engine_calls) {
+    results.push_back({name, iterations, ns, allocations, engine_calls});
+  }
+};
@@ -0,0 +1,56 @@
+#include "bench.h"
+
+static const size_t iterations = 100000;
+
+int
+main (int argc, char *argv[]) {
+  Bench bench(argc, argv);
+
+  auto &runtime = bench.runtime;
+
+  jsi::Scope scope(runtime);
+
+  auto function = runtime
+                    .evaluateJavaScript(std::make_shared<jsi::StringBuffer>("(function () { throw new Error('fail') })"), "bench.js")
+                    .asObject(runtime)
+                    .asFunction(runtime);
+
+  auto object = runtime
+                  .evaluateJavaScript(std::make_shared<jsi::StringBuffer>("({ get value () { throw new Error('fail') } })"), "bench.js")
+                  .asObject(runtime);
+
+  auto name = jsi::PropNameID::forAscii(runtime, "value");
+
+  bench.run("exception/call/throw", iterations, [&] (size_t) {
+    try {
+      function.call(runtime);
+    } catch (const jsi::JSError &) {
+    }
+  });
+
+  bench.run("exception/call/try", iterations, [&] (size_t) {
+    runtime.tryCall(function, jsi::Value::undefined(), nullptr, 0);
+  });
+
+  bench.run("exception/get/throw", iterations, [&] (size_t) {
+    try {
+      object.getProperty(runtime, name);
+    } catch (const jsi::JSError &) {
+    }
+  });
+
+  bench.run("exception/get/try", iterations, [&] (size_t) {
+    runtime.tryGetProperty(object, name);
+  });
+
+  runtime.setLazyErrors(true);
+
+  bench.run("exception/call/throw-lazy", iterations, [&] (size_t) {
+    try {
+      function.call(runtime);
+    } catch (const jsi::JSError &) {
+    }
+  });
+
+  bench.report();
+}
@@ -0,0 +1,46 @@
+#include "bench.h"
+
+static const size_t iterations = 1000000;
+
+int
+main (int argc, char *argv[]) {
+  Bench bench(argc, argv);
+
+  auto &runtime = bench.runtime;
+
+  jsi::Scope scope(runtime);
+
+  auto function = runtime
+                    .evaluateJavaScript(std::make_shared<jsi::StringBuffer>("(function () {})"), "bench.js")
+                    .asObject(runtime)
+                    .asFunction(runtime);
+
+  std::vector<jsi::Value> args;
+
+  for (int i = 0; i < 16; i++) {
+    if (i % 2) args.emplace_back(jsi::String::createFromAscii(runtime, "hello"));
+    else args.emplace_back(jsi::Object(runtime));
+  }
+
+  const jsi::Value *values = args.data();
+
+  for (size_t count : {0, 4, 8, 16}) {
+    auto name = "function-call/" + std::to_string(count);
+
+    bench.run(name.c_str(), iterations, [&] (size_t) {
+      function.call(runtime, values, count);
+    });
+  }
+
+  JSIRuntime::JSICallSite site(runtime, function, jsi::Value::undefined());
+
+  for (size_t count : {0, 4, 8, 16}) {
+    auto name = "function-call/site/" + std::to_string(count);
+
+    bench.run(name.c_str(), iterations, [&] (size_t) {
+      site.call(values, count);
+    });
+  }
+
+  bench.report();
+}
@@ -0,0 +1,44 @@
+#include "bench.h"
+
+static const size_t iterations = 1000000;
+
+int
+main (int argc, char *argv[]) {
+  Bench bench(argc, argv);
+
+  auto &runtime = bench.runtime;
+
+  jsi::Scope scope(runtime);
+
+  auto object = jsi::Object(runtime);
+
+  auto name = jsi::PropNameID::forAscii(runtime, "value");
+
+  auto string = jsi::String::createFromAscii(runtime, "value");
+
+  bench.run("property/set/prop-name", iterations, [&] (size_t i) {
+    object.setProperty(runtime, name, static_cast<int>(i));
+  });
+
+  bench.run("property/set/string", iterations, [&] (size_t i) {
+    object.setProperty(runtime, string, static_cast<int>(i));
+  });
+
+  bench.run("property/set/c-string", iterations, [&] (size_t i) {
+    object.setProperty(runtime, "value", static_cast<int>(i));
+  });
+
+  bench.run("property/get/prop-name", iterations, [&] (size_t) {
+    object.getProperty(runtime, name);
+  });
+
+  bench.run("property/get/string", iterations, [&] (size_t) {
+    object.getProperty(runtime, string);
+  });
+
+  bench.run("property/get/c-string", iterations, [&] (size_t) {
+    object.getProperty(runtime, "value");
+  });
+
+  bench.report();
+}
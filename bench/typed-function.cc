@@ -0,0 +1,43 @@
+#include "bench.h"
+
+static const size_t iterations = 10000;
+
+int
+main (int argc, char *argv[]) {
+  Bench bench(argc, argv);
+
+  auto &runtime = bench.runtime;
+
+  jsi::Scope scope(runtime);
+
+  auto loop = runtime
+                .evaluateJavaScript(std::make_shared<jsi::StringBuffer>("(function (add) { let sum = 0; for (let i = 0; i < 1000; i++) sum = add(sum, i); return sum })"), "bench.js")
+                .asObject(runtime)
+                .asFunction(runtime);
+
+  auto host = jsi::Function::createFromHostFunction(runtime, jsi::PropNameID::forAscii(runtime, "add"), 2, [] (jsi::Runtime &, const jsi::Value &, const jsi::Value *args, size_t) -> jsi::Value {
+    return jsi::Value(args[0].asNumber() + args[1].asNumber());
+  });
+
+  auto typed = runtime.createTypedFunction(jsi::PropNameID::forAscii(runtime, "add"), [] (double a, double b) -> double {
+    return a + b;
+  });
+
+  auto fast = runtime.createTypedFunction(jsi::PropNameID::forAscii(runtime, "add"), [] (double a, double b) noexcept -> double {
+    return a + b;
+  });
+
+  bench.run("typed-function/loop-1000/host", iterations, [&] (size_t) {
+    loop.call(runtime, host);
+  });
+
+  bench.run("typed-function/loop-1000/typed", iterations, [&] (size_t) {
+    loop.call(runtime, typed);
+  });
+
+  bench.run("typed-function/loop-1000/fast", iterations, [&] (size_t) {
+    loop.call(runtime, fast);
+  });
+
+  bench.report();
+}
@@ -0,0 +1,76 @@
+#include "bench.h"
+
+static const size_t iterations = 1000000;
+
+int
+main (int argc, char *argv[]) {
+  Bench bench(argc, argv);
+
+  auto &runtime = bench.runtime;
+
+  jsi::Scope scope(runtime);
+
+  auto holder = jsi::Object(runtime);
+
+  auto name = jsi::PropNameID::forAscii(runtime, "value");
+
+  auto symbol = runtime
+                  .evaluateJavaScript(std::make_shared<jsi::StringBuffer>("Symbol('bench')"), "bench.js")
+                  .asSymbol(runtime);
+
+  struct Kind {
+    const char *name;
+    std::function<jsi::Value()> create;
+  };
+
+  const Kind kinds[] = {
+    {"undefined", [] { return jsi::Value::undefined(); }},
+    {"null", [] { return jsi::Value::null(); }},
+    {"bool", [] { return jsi::Value(true); }},
+    {"number", [] { return jsi::Value(42); }},
+    {"double", [] { return jsi::Value(4.2); }},
+    {"string", [&] { return jsi::Value(jsi::String::createFromAscii(runtime, "hello")); }},
+    {"bigint", [&] { return jsi::Value(jsi::BigInt::fromInt64(runtime, 42)); }},
+    {"symbol", [&] { return jsi::Value(runtime, symbol); }},
+    {"object", [&] { return jsi::Value(jsi::Object(runtime)); }},
+  };
+
+  for (auto &kind : kinds) {
+    auto value = kind.create();
+
+    std::string prefix = kind.name;
+
+    bench.run(("value/create/" + prefix).c_str(), iterations, [&] (size_t) {
+      kind.create();
+    });
+
+    bench.run(("value/clone/" + prefix).c_str(), iterations, [&] (size_t) {
+      jsi::Value(runtime, value);
+    });
+
+    bench.run(("value/convert/" + prefix).c_str(), iterations, [&] (size_t) {
+      holder.setProperty(runtime, name, value);
+      holder.getProperty(runtime, name);
+    });
+
+    bench.run(
+      ("value/destroy/" + prefix).c_str(),
+      iterations,
+      [&] (size_t n) {
+        std::vector<jsi::Value> values;
+        values.reserve(n);
+
+        for (size_t i = 0; i < n; i++) {
+          values.emplace_back(runtime, value);
+        }
+
+        return values;
+      },
+      [] (std::vector<jsi::Value> &values) {
+        values.clear();
+      }
+    );
+  }
+
+  bench.report();
+}
@@ -1,13 +1,23 @@
 #pragma once
 
+#include <array>
+#include <atomic>
 #include <chrono>
+#include <cmath>
 #include <deque>
 #include <exception>
 #include <functional>
+#include <initializer_list>
 #include <memory>
+#include <new>
 #include <ostream>
+#include <span>
 #include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include <assert.h>
@@ -113,13 +123,51 @@ struct JSIPlatform {
   operator=(const JSIPlatform &) = delete;
 };
 
+// A host object with additional hooks for checking for and deleting
+// properties. Host objects deriving from it are asked directly by `in`
+// checks and `delete`, rather than those being answered through get(). Those
+// constructed with `atoms` set are passed the interned jsi::PropNameID of
+// names interned beforehand; looking names up costs every access a string
+// read, so other hosts are passed a fresh jsi::PropNameID.
+struct JSIHostObject : jsi::HostObject {
+  const bool atoms;
+
+  JSIHostObject(bool atoms = false)
+      : atoms(atoms) {}
+
+  // By default a property exists if get() returns anything but undefined,
+  // so any side effects of get() also run on every `in` check. Override this
+  // when get() isn't free of them.
+  virtual bool
+  has(jsi::Runtime &runtime, const jsi::PropNameID &name) {
+    return !get(runtime, name).isUndefined();
+  }
+
+  // Return whether the property was deleted. By default nothing is, so
+  // `delete` reports failure rather than claiming to have removed a
+  // property that is still there.
+  virtual bool
+  deleteProperty(jsi::Runtime &runtime, const jsi::PropNameID &name) {
+    return false;
+  }
+};
+
+struct JSIPoolStats {
+  size_t hits;
+  size_t misses;
+  size_t slabs;
+  size_t live;
+};
+
 struct JSIRuntime : jsi::Runtime {
   uv_loop_t loop;
   js_platform_t *platform;
   js_env_t *env;
 
   JSIRuntime(js_platform_t *platform)
-      : platform(platform) {
+      : platform(platform),
+        pointer_values(*this),
+        weak_pointer_values(*this) {
     int err;
 
     err = uv_loop_init(&loop);
@@ -127,6 +175,15 @@ struct JSIRuntime : jsi::Runtime {
 
     err = js_create_env(&loop, this->platform, nullptr, &env);
     assert(err == 0);
+
+    thread = uv_thread_self();
+
+    err = uv_async_init(&loop, &release_async, onrelease);
+    assert(err == 0);
+
+    release_async.data = this;
+
+    uv_unref(reinterpret_cast<uv_handle_t *>(&release_async));
   }
 
   JSIRuntime(const JSIPlatform &platform)
@@ -137,6 +194,25 @@ struct JSIRuntime : jsi::Runtime {
   ~JSIRuntime() override {
     int err;
 
+    assert(scopes.empty());
+
+    microtask_queue.clear();
+
+    atom_names.clear();
+    atoms.clear();
+
+    host_classes.clear();
+
+    if (batch_function) release(batch_function);
+
+    flushReleases();
+
+    closing.store(true, std::memory_order_release);
+
+    uv_close(reinterpret_cast<uv_handle_t *>(&release_async), nullptr);
+
+    tearing_down = true;
+
     err = js_destroy_env(env);
     assert(err == 0);
 
@@ -154,22 +230,89 @@ struct JSIRuntime : jsi::Runtime {
   JSIRuntime &
   operator=(const JSIRuntime &) = delete;
 
+  // The outcome of an operation that may throw, holding either its result or
+  // the value that was thrown.
+  struct JSIResult {
+    jsi::Value value;
+    bool threw;
+
+    explicit operator bool() const {
+      return !threw;
+    }
+  };
+
   jsi::Value
   evaluateJavaScript(
     const std::shared_ptr<const jsi::Buffer> &buffer,
     const std::string &file
   ) override {
+    return unwrap(tryEvaluateJavaScript(buffer, file));
+  }
+
+  // The try variants below report a JavaScript exception through their
+  // result rather than by throwing, for callers where failing is common
+  // enough that C++ unwinding would dominate.
+  JSIResult
+  tryEvaluateJavaScript(const std::shared_ptr<const jsi::Buffer> &buffer, const std::string &file) {
     int err;
 
     js_value_t *source;
     err = js_create_string_utf8(env, buffer->data(), buffer->size(), &source);
-    if (err < 0) throw lastException();
+    if (err < 0) return pendingException();
 
     js_value_t *result;
     err = js_run_script(env, file.data(), file.length(), 0, source, &result);
-    if (err < 0) throw lastException();
+    if (err < 0) return pendingException();
+
+    return {as(result), false};
+  }
+
+  JSIResult
+  tryGetProperty(const jsi::Object &object, const jsi::PropNameID &key) {
+    int err;
 
-    return as(result);
+    js_value_t *value;
+    err = js_get_property(env, as(object), as(key), &value);
+    if (err < 0) return pendingException();
+
+    return {as(value), false};
+  }
+
+  JSIResult
+  tryGetProperty(const jsi::Object &object, const jsi::String &key) {
+    int err;
+
+    js_value_t *value;
+    err = js_get_property(env, as(object), as(key), &value);
+    if (err < 0) return pendingException();
+
+    return {as(value), false};
+  }
+
+  JSIResult
+  tryCall(const jsi::Function &function, const jsi::Value &receiver, const jsi::Value *args, size_t count) {
+    int err;
+
+    JSIArgumentBuffer argv(*this, args, count);
+
+    js_value_t *result;
+    err = js_call_function(env, as(receiver), as(function), count, argv.argv, &result);
+    if (err < 0) return pendingException();
+
+    return {as(result), false};
+  }
+
+  JSIResult
+  tryCallAsConstructor(const jsi::Function &constructor, const jsi::Value *args, size_t count) {
+    int err;
+
+    JSIArgumentBuffer argv(*this, args, count);
+
+    js_value_t *result;
+    err = js_new_instance(env, as(constructor), count, argv.argv, &result);
+    if (err < 0) return pendingException();
+
+    return {as(result), false};
   }
 
   std::shared_ptr<const jsi::PreparedJavaScript>
@@ -204,6 +347,8 @@ struct JSIRuntime : jsi::Runtime {
       callback.call(*this);
     }
 
+    flushReleases();
+
     return true; // Happens automatically at the JavaScript/C boundary
   }
 
@@ -215,7 +360,7 @@ struct JSIRuntime : jsi::Runtime {
     err = js_get_global(env, &global);
     if (err < 0) throw lastException();
 
-    return make<jsi::Object>(global);
+    return make<jsi::Object>(global, JSIAllKinds, 0);
   }
 
   std::string
@@ -239,840 +384,2589 @@ struct JSIRuntime : jsi::Runtime {
     return JSIInstrumentation::instance;
   }
 
-protected:
-  PointerValue *
-  cloneSymbol(const PointerValue *pv) override {
-    return new JSIPointerValue(env, as<JSIPointerValue>(pv)->ref);
-  }
+  enum JSIKind : uint8_t {
+    JSIArrayKind = 1 << 0,
+    JSIArrayBufferKind = 1 << 1,
+    JSIFunctionKind = 1 << 2,
+    JSIHostObjectKind = 1 << 3,
+    JSIHostFunctionKind = 1 << 4,
+    JSIAllKinds = (1 << 5) - 1,
+  };
 
-  PointerValue *
-  cloneBigInt(const PointerValue *pv) override {
-    return new JSIPointerValue(env, as<JSIPointerValue>(pv)->ref);
+  uint8_t
+  classify(const jsi::Object &object) const {
+    return resolve(as<JSIPointerValue>(object), JSIAllKinds);
   }
 
-  PointerValue *
-  cloneString(const PointerValue *pv) override {
-    return new JSIPointerValue(env, as<JSIPointerValue>(pv)->ref);
-  }
+  void
+  flushReleases() {
+    int err;
 
-  PointerValue *
-  cloneObject(const PointerValue *pv) override {
-    return new JSIPointerValue(env, as<JSIPointerValue>(pv)->ref);
+    auto deferred = deferred_releases.exchange(nullptr, std::memory_order_acquire);
+
+    while (deferred) {
+      auto next = deferred->next;
+
+      deferred->value->invalidate();
+
+      delete deferred;
+
+      deferred = next;
+    }
+
+    for (auto ref : release_queue) {
+      err = js_delete_reference(env, ref);
+      assert(err == 0);
+    }
+
+    release_queue.clear();
   }
 
-  PointerValue *
-  clonePropNameID(const PointerValue *pv) override {
-    return new JSIPointerValue(env, as<JSIPointerValue>(pv)->ref);
+  size_t
+  pendingReleases() const {
+    return release_queue.size();
   }
 
-  jsi::PropNameID
-  createPropNameIDFromAscii(const char *str, size_t len) override {
-    int err;
+  void
+  setReleaseThreshold(size_t threshold) {
+    release_threshold = threshold;
 
-    js_value_t *value;
-    err = js_create_string_utf8(env, reinterpret_cast<const utf8_t *>(str), len, &value);
-    if (err < 0) throw lastException();
+    if (release_queue.size() >= release_threshold) flushReleases();
+  }
 
-    return make<jsi::PropNameID>(value);
+  // Defer reading the message and stack of thrown errors until they're
+  // asked for through what(), message() or stack() of a JSIError. This makes
+  // throwing and catching errors that are never inspected cheap, at the cost
+  // of jsi::JSError::getMessage() and getStack() being empty for them.
+  void
+  setLazyErrors(bool lazy) {
+    lazy_errors = lazy;
   }
 
-  jsi::PropNameID
-  createPropNameIDFromUtf8(const uint8_t *str, size_t len) override {
+  // Limit the number of frames captured in the stack of errors created from
+  // now on, where capturing fewer frames makes creating them cheaper.
+  void
+  setStackTraceLimit(size_t limit) {
+    global()
+      .getPropertyAsObject(*this, "Error")
+      .setProperty(*this, "stackTraceLimit", static_cast<double>(limit));
+  }
+
+  // Intern a property name, returning its atom. Host objects deriving from
+  // JSIHostObject with atoms enabled are passed the interned jsi::PropNameID
+  // for property names that have been interned, so they can compare atoms
+  // instead of strings. Other host objects are passed a fresh
+  // jsi::PropNameID as before.
+  uint32_t
+  intern(std::string_view name) {
     int err;
 
+    auto it = atoms.find(name);
+
+    if (it != atoms.end()) return atom(it->second);
+
     js_value_t *value;
-    err = js_create_string_utf8(env, str, len, &value);
+    err = js_create_string_utf8(env, reinterpret_cast<const utf8_t *>(name.data()), name.length(), &value);
     if (err < 0) throw lastException();
 
-    return make<jsi::PropNameID>(value);
+    return atom(intern(name, value));
   }
 
-  jsi::PropNameID
-  createPropNameIDFromString(const jsi::String &str) override {
-    return Runtime::make<jsi::PropNameID>(cloneString(getPointerValue(str)));
+  // The atom of an interned property name, or 0 if it isn't interned.
+  uint32_t
+  atom(const jsi::PropNameID &name) const {
+    return as<JSIPointerValue>(name)->atom;
   }
 
-  jsi::PropNameID
-  createPropNameIDFromSymbol(const jsi::Symbol &sym) override {
-    return Runtime::make<jsi::PropNameID>(cloneSymbol(getPointerValue(sym)));
+  const JSIPoolStats &
+  pointerValueStats() const {
+    return pointer_values.stats;
   }
 
-  std::string
-  utf8(const jsi::PropNameID &prop) override {
-    return as<JSIPointerValue>(prop)->toString(*this);
+  const JSIPoolStats &
+  weakPointerValueStats() const {
+    return weak_pointer_values.stats;
   }
 
-  bool
-  compare(const jsi::PropNameID &a, const jsi::PropNameID &b) override {
-    return strictEquals(static_cast<const jsi::Pointer &>(a), b);
-  }
+  // An exception thrown from JavaScript. Its message and stack are read the
+  // same way jsi::JSError reads them, coercing values that aren't strings
+  // with String(). With lazy errors enabled they're read from the thrown
+  // value the first time they're needed through what(), message() or
+  // stack(), which must be while the runtime is still alive and on its
+  // thread. getMessage() and getStack() of such an error stay empty.
+  struct JSIError : jsi::JSError {
+    JSIError(JSIRuntime &runtime, jsi::Value &&value)
+        : JSIError(runtime, std::move(value), runtime.lazy_errors ? JSIErrorInfo{} : describe(runtime, value)) {}
 
-  std::string
-  symbolToString(const jsi::Symbol &sym) override {
-    return global()
-      .getPropertyAsFunction(*this, "String")
-      .call(*this, jsi::Value(*this, sym))
-      .asString(*this)
-      .utf8(*this);
-  }
+    const char *
+    what() const noexcept override {
+      if (!lazy) return jsi::JSError::what();
 
-  jsi::BigInt
-  createBigIntFromInt64(int64_t n) override {
-    int err;
+      materialize();
 
-    js_value_t *value;
-    err = js_create_bigint_int64(env, n, &value);
-    if (err < 0) throw lastException();
+      return lazy_what.c_str();
+    }
 
-    return make<jsi::BigInt>(value);
-  }
+    const std::string &
+    message() const {
+      if (!lazy) return getMessage();
 
-  jsi::BigInt
-  createBigIntFromUint64(uint64_t n) override {
-    int err;
+      materialize();
 
-    js_value_t *value;
-    err = js_create_bigint_uint64(env, n, &value);
-    if (err < 0) throw lastException();
+      return lazy_message;
+    }
 
-    return make<jsi::BigInt>(value);
-  }
+    const std::string &
+    stack() const {
+      if (!lazy) return getStack();
 
-  bool
-  bigintIsInt64(const jsi::BigInt &bigint) override {
-    int err;
+      materialize();
 
-    bool lossless;
-    err = js_get_value_bigint_int64(env, as(bigint), nullptr, &lossless);
-    if (err < 0) throw lastException();
+      return lazy_stack;
+    }
 
-    return lossless;
-  }
+  private:
+    struct JSIErrorInfo {
+      std::string message;
+      std::string stack;
+    };
 
-  bool
-  bigintIsUint64(const jsi::BigInt &bigint) override {
-    int err;
+    mutable JSIRuntime *runtime;
+    bool lazy;
+    mutable std::string lazy_message;
+    mutable std::string lazy_stack;
+    mutable std::string lazy_what;
+
+    JSIError(JSIRuntime &runtime, jsi::Value &&value, JSIErrorInfo &&info)
+        : jsi::JSError(std::move(value), std::move(info.message), std::move(info.stack)),
+          runtime(runtime.lazy_errors ? &runtime : nullptr),
+          lazy(runtime.lazy_errors) {}
+
+    static std::string
+    coerce(jsi::Runtime &rt, const jsi::Value &value) {
+      if (value.isString()) return value.getString(rt).utf8(rt);
+
+      return rt.global()
+        .getPropertyAsFunction(rt, "String")
+        .call(rt, value)
+        .asString(rt)
+        .utf8(rt);
+    }
 
-    bool lossless;
-    err = js_get_value_bigint_uint64(env, as(bigint), nullptr, &lossless);
-    if (err < 0) throw lastException();
+    static JSIErrorInfo
+    describe(jsi::Runtime &rt, const jsi::Value &value) noexcept {
+      JSIErrorInfo info;
 
-    return lossless;
-  }
+      if (value.isObject()) {
+        auto object = value.getObject(rt);
 
-  uint64_t
-  truncate(const jsi::BigInt &bigint) override {
-    int err;
+        try {
+          auto message = object.getProperty(rt, "message");
 
-    uint64_t value;
-    err = js_get_value_bigint_uint64(env, as(bigint), &value, nullptr);
-    if (err < 0) throw lastException();
+          if (!message.isUndefined()) info.message = coerce(rt, message);
+        } catch (const std::exception &error) {
+          info.message = std::string("[Exception while creating message string: ") + error.what() + "]";
+        }
 
-    return value;
-  }
+        try {
+          auto stack = object.getProperty(rt, "stack");
 
-  jsi::String
-  bigintToString(const jsi::BigInt &bigint, int radix) override {
-    return global()
-      .getPropertyAsFunction(*this, "String")
-      .call(*this, jsi::Value(*this, bigint))
-      .asString(*this);
-  }
+          if (!stack.isUndefined()) info.stack = coerce(rt, stack);
+        } catch (const std::exception &error) {
+          info.stack = std::string("[Exception while creating stack string: ") + error.what() + "]";
+        }
+      }
 
-  jsi::String
-  createStringFromAscii(const char *str, size_t len) override {
-    int err;
+      if (info.message.empty()) {
+        try {
+          info.message = coerce(rt, value);
+        } catch (const std::exception &error) {
+          info.message = std::string("[Exception while creating message string: ") + error.what() + "]";
+        }
+      }
 
-    js_value_t *value;
-    err = js_create_string_utf8(env, reinterpret_cast<const utf8_t *>(str), len, &value);
-    if (err < 0) throw lastException();
+      if (info.stack.empty()) info.stack = "no stack";
 
-    return make<jsi::String>(value);
-  }
+      return info;
+    }
 
-  jsi::String
-  createStringFromUtf8(const uint8_t *str, size_t len) override {
-    int err;
+    void
+    materialize() const noexcept {
+      if (runtime == nullptr) return;
 
-    js_value_t *value;
-    err = js_create_string_utf8(env, str, len, &value);
-    if (err < 0) throw lastException();
+      auto &rt = *runtime;
 
-    return make<jsi::String>(value);
-  }
+      runtime = nullptr;
 
-  std::string
-  utf8(const jsi::String &string) override {
-    return as<JSIPointerValue>(string)->toString(*this);
-  }
+      auto info = describe(rt, this->value());
 
-  jsi::Value
-  createValueFromJsonUtf8(const uint8_t *json, size_t length) override {
-    return global()
-      .getPropertyAsObject(*this, "JSON")
-      .getPropertyAsFunction(*this, "parse")
-      .call(*this, jsi::String::createFromUtf8(*this, json, length));
-  }
+      lazy_message = std::move(info.message);
+      lazy_stack = std::move(info.stack);
+      lazy_what = lazy_message + "\n\n" + lazy_stack;
+    }
+  };
 
-  jsi::Object
-  createObject() override {
-    int err;
+  // A borrowed view of a host function argument. Views hold the raw engine
+  // handle and are only valid for the duration of the call that received
+  // them; use toValue() to obtain an owning jsi::Value. The type of the
+  // argument is read once per view and reused by every is*() check, so keep
+  // hold of a view rather than indexing JSIArguments repeatedly.
+  struct JSIArgument {
+    JSIRuntime &runtime;
+    js_value_t *value;
+    mutable bool typed = false;
+    mutable js_value_type_t cached_type;
 
-    js_value_t *result;
-    err = js_create_object(env, &result);
-    if (err < 0) throw lastException();
+    js_value_type_t
+    type() const {
+      int err;
 
-    return make<jsi::Object>(result);
-  }
+      if (typed) return cached_type;
 
-  jsi::Object
-  createObject(std::shared_ptr<jsi::HostObject> object) override {
-    int err;
+      err = js_typeof(runtime.env, value, &cached_type);
+      assert(err == 0);
 
-    auto ref = new JSIHostObjectReference(*this, std::move(object));
+      typed = true;
 
-    js_delegate_callbacks_t callbacks = {
-      .get = JSIHostObjectReference::get,
-      .set = JSIHostObjectReference::set,
-      .own_keys = JSIHostObjectReference::ownKeys,
-    };
+      return cached_type;
+    }
 
-    js_value_t *result;
-    err = js_create_delegate(env, &callbacks, ref, finalize<JSIHostObjectReference>, ref, &result);
-    if (err < 0) throw lastException();
+    bool
+    isUndefined() const {
+      return type() == js_undefined;
+    }
 
-    err = js_wrap(env, result, ref, nullptr, nullptr, nullptr);
-    assert(err == 0);
+    bool
+    isNull() const {
+      return type() == js_null;
+    }
 
-    err = js_add_type_tag(env, result, &JSIHostObjectReference::tag);
-    assert(err == 0);
+    bool
+    isBool() const {
+      return type() == js_boolean;
+    }
 
-    return make<jsi::Object>(result);
-  }
+    bool
+    isNumber() const {
+      return type() == js_number;
+    }
 
-  std::shared_ptr<jsi::HostObject>
-  getHostObject(const jsi::Object &object) override {
-    int err;
+    bool
+    isString() const {
+      return type() == js_string;
+    }
 
-    JSIHostObjectReference *ref;
-    err = js_unwrap(env, as(object), reinterpret_cast<void **>(&ref));
-    assert(err == 0);
+    bool
+    isBigInt() const {
+      return type() == js_bigint;
+    }
 
-    return ref->object;
-  }
+    bool
+    isSymbol() const {
+      return type() == js_symbol;
+    }
 
-  jsi::HostFunctionType &
-  getHostFunction(const jsi::Function &function) override {
-    int err;
+    bool
+    isObject() const {
+      auto type = this->type();
 
-    JSIHostFunctionReference *ref;
-    err = js_unwrap(env, as(function), reinterpret_cast<void **>(&ref));
-    assert(err == 0);
+      return type == js_object || type == js_function || type == js_external;
+    }
+
+    bool
+    getBool() const {
+      int err;
+
+      bool result;
+      err = js_get_value_bool(runtime.env, value, &result);
+      if (err < 0) throw runtime.lastException();
+
+      return result;
+    }
+
+    double
+    getNumber() const {
+      int err;
+
+      double result;
+      err = js_get_value_double(runtime.env, value, &result);
+      if (err < 0) throw runtime.lastException();
+
+      return result;
+    }
+
+    int32_t
+    getInt32() const {
+      int err;
+
+      int32_t result;
+      err = js_get_value_int32(runtime.env, value, &result);
+      if (err < 0) throw runtime.lastException();
+
+      return result;
+    }
+
+    uint32_t
+    getUint32() const {
+      int err;
+
+      uint32_t result;
+      err = js_get_value_uint32(runtime.env, value, &result);
+      if (err < 0) throw runtime.lastException();
+
+      return result;
+    }
+
+    std::string
+    utf8() const {
+      int err;
+
+      size_t len;
+      err = js_get_value_string_utf8(runtime.env, value, nullptr, 0, &len);
+      if (err < 0) throw runtime.lastException();
+
+      std::string result;
+
+      result.resize(len);
+
+      err = js_get_value_string_utf8(runtime.env, value, reinterpret_cast<utf8_t *>(result.data()), len, nullptr);
+      assert(err == 0);
+
+      return result;
+    }
+
+    jsi::Value
+    toValue() const {
+      return runtime.as(value);
+    }
+  };
+
+  // The arguments and receiver of a host function call, borrowed from the
+  // engine for the duration of the call.
+  struct JSIArguments {
+    JSIRuntime &runtime;
+    js_value_t *receiver;
+    js_value_t *const *argv;
+    size_t argc;
+
+    size_t
+    size() const {
+      return argc;
+    }
+
+    JSIArgument
+    operator[](size_t i) const {
+      assert(i < argc);
+
+      return JSIArgument{runtime, argv[i]};
+    }
+
+    JSIArgument
+    self() const {
+      return JSIArgument{runtime, receiver};
+    }
+
+    jsi::Value
+    thisValue() const {
+      return runtime.as(receiver);
+    }
+  };
+
+  // A function pinned together with its receiver and any leading bound
+  // arguments for repeated calls. The handles of the pinned values are
+  // resolved once per scope, so a call only has to marshal the arguments
+  // that vary between calls.
+  struct JSICallSite {
+    JSICallSite(JSIRuntime &runtime, const jsi::Function &function, const jsi::Value &receiver, const jsi::Value *bound, size_t count)
+        : runtime(runtime),
+          function(runtime, function),
+          receiver(runtime, receiver),
+          bound(),
+          argv(count),
+          scope(0) {
+      this->bound.reserve(count);
+
+      for (size_t i = 0; i < count; i++) {
+        this->bound.emplace_back(runtime, bound[i]);
+      }
+    }
+
+    JSICallSite(JSIRuntime &runtime, const jsi::Function &function, const jsi::Value &receiver, std::initializer_list<jsi::Value> bound = {})
+        : JSICallSite(runtime, function, receiver, bound.begin(), bound.size()) {}
+
+    JSICallSite(const JSICallSite &) = delete;
+
+    JSICallSite &
+    operator=(const JSICallSite &) = delete;
+
+    jsi::Value
+    call(const jsi::Value *args, size_t count) {
+      int err;
+
+      auto n = bound.size();
+
+      if (runtime.scopes.empty() || runtime.scopes.back().id != scope) {
+        function_handle = runtime.as(function);
+        receiver_handle = runtime.as(receiver);
+
+        for (size_t i = 0; i < n; i++) {
+          argv[i] = runtime.as(bound[i]);
+        }
+
+        scope = runtime.scopes.empty() ? 0 : runtime.scopes.back().id;
+      }
+
+      if (argv.size() < n + count) argv.resize(n + count);
+
+      for (size_t i = 0; i < count; i++) {
+        argv[n + i] = runtime.as(args[i]);
+      }
+
+      js_value_t *result;
+      err = js_call_function(runtime.env, receiver_handle, function_handle, n + count, argv.data(), &result);
+      if (err < 0) throw runtime.lastException();
+
+      return runtime.as(result);
+    }
+
+    jsi::Value
+    call(std::initializer_list<jsi::Value> args) {
+      return call(args.begin(), args.size());
+    }
+
+  private:
+    JSIRuntime &runtime;
+    jsi::Value function;
+    jsi::Value receiver;
+    std::vector<jsi::Value> bound;
+    std::vector<js_value_t *> argv;
+    uint64_t scope;
+    js_value_t *function_handle;
+    js_value_t *receiver_handle;
+  };
+
+  // Call a function once for each of `count` argument tuples of `arity`
+  // arguments, laid out back to back in `args`. All calls are made from a
+  // single entry into JavaScript, so the boundary is only crossed once for
+  // the whole batch. An exception thrown by a call doesn't stop the batch;
+  // it's reported as the value of that call with `threw` set.
+  std::vector<JSIResult>
+  callBatch(const jsi::Function &function, const jsi::Value &receiver, const jsi::Value *args, size_t arity, size_t count) {
+    int err;
+
+    js_value_t *argv[6] = {as(function), as(receiver)};
+
+    std::vector<const js_value_t *> elements;
+
+    elements.reserve(arity * count);
+
+    for (size_t i = 0, n = arity * count; i < n; i++) {
+      elements.push_back(as(args[i]));
+    }
+
+    err = js_create_array_with_length(env, elements.size(), &argv[2]);
+    if (err < 0) throw lastException();
+
+    err = js_set_array_elements(env, argv[2], elements.data(), elements.size(), 0);
+    if (err < 0) throw lastException();
+
+    err = js_create_int64(env, static_cast<int64_t>(arity), &argv[3]);
+    assert(err == 0);
+
+    err = js_create_array_with_length(env, count, &argv[4]);
+    if (err < 0) throw lastException();
+
+    err = js_create_array(env, &argv[5]);
+    if (err < 0) throw lastException();
+
+    js_value_t *result;
+    err = js_call_function(env, as(JSIUndefined), batchFunction(), 6, argv, &result);
+    if (err < 0) throw lastException();
+
+    std::vector<js_value_t *> values(count);
+
+    err = js_get_array_elements(env, argv[4], values.data(), values.size(), 0, nullptr);
+    if (err < 0) throw lastException();
+
+    std::vector<JSIResult> results;
+
+    results.reserve(count);
+
+    for (auto value : values) {
+      results.push_back({as(value), false});
+    }
+
+    uint32_t len;
+    err = js_get_array_length(env, argv[5], &len);
+    assert(err == 0);
+
+    if (len == 0) return results;
+
+    values.resize(len);
+
+    err = js_get_array_elements(env, argv[5], values.data(), len, 0, nullptr);
+    if (err < 0) throw lastException();
+
+    for (auto value : values) {
+      uint32_t index;
+      err = js_get_value_uint32(env, value, &index);
+      assert(err == 0);
+
+      results[index].threw = true;
+    }
+
+    return results;
+  }
+
+  using JSIArgumentsFunctionType = std::function<jsi::Value(JSIRuntime &runtime, const JSIArguments &args)>;
+
+  // Create a function backed by a host callback that receives its arguments
+  // as borrowed views rather than owning jsi::Value instances. The result is
+  // not a jsi host function; isHostFunction() reports false for it.
+  jsi::Function
+  createFunction(const jsi::PropNameID &name, unsigned int paramCount, JSIArgumentsFunctionType function) {
+    int err;
+
+    auto ref = new JSIArgumentsFunctionReference(*this, std::move(function));
+
+    auto str = as<JSIPointerValue>(name)->toString(*this);
+
+    js_value_t *result;
+    err = js_create_function(env, str.data(), str.length(), trampoline<JSIArgumentsFunctionReference>(paramCount), ref, &result);
+    if (err < 0) throw lastException();
+
+    err = js_wrap(env, result, ref, finalize<JSIArgumentsFunctionReference>, ref, nullptr);
+    assert(err == 0);
+
+    return make<jsi::Function>(result, JSIAllKinds, JSIFunctionKind);
+  }
+
+  using JSIHostFunctionPointer = jsi::Value (*)(jsi::Runtime &runtime, const jsi::Value &thisValue, const jsi::Value *args, size_t count, void *data);
+
+  // Create a function from a callable with the signature of a jsi host
+  // function. The callable is moved into the function and invoked directly,
+  // so it may be move-only and is never wrapped in a jsi::HostFunctionType.
+  // The result is not a jsi host function; isHostFunction() reports false
+  // for it.
+  template <typename F>
+  jsi::Function
+  createFunctionFromCallable(const jsi::PropNameID &name, unsigned int paramCount, F function) {
+    int err;
+
+    auto ref = new JSICallableReference<F>(*this, std::move(function));
+
+    auto str = as<JSIPointerValue>(name)->toString(*this);
+
+    js_value_t *result;
+    err = js_create_function(env, str.data(), str.length(), trampoline<JSICallableReference<F>>(paramCount), ref, &result);
+    if (err < 0) throw lastException();
+
+    err = js_wrap(env, result, ref, finalize<JSICallableReference<F>>, ref, nullptr);
+    assert(err == 0);
+
+    return make<jsi::Function>(result, JSIAllKinds, JSIFunctionKind);
+  }
+
+  // Create a function from a plain function pointer and an opaque data
+  // pointer that is passed back on every call. The data is not owned by the
+  // function and must outlive it.
+  jsi::Function
+  createFunctionFromPointer(const jsi::PropNameID &name, unsigned int paramCount, JSIHostFunctionPointer function, void *data) {
+    return createFunctionFromCallable(name, paramCount, JSIHostFunctionPointerCall{function, data});
+  }
+
+  struct JSIHostMethod {
+    std::string name;
+    unsigned int paramCount;
+    jsi::HostFunctionType function;
+  };
+
+  // Either side of an accessor may be left empty. The getter is called
+  // without arguments and the setter with the assigned value.
+  struct JSIHostAccessor {
+    std::string name;
+    jsi::HostFunctionType getter;
+    jsi::HostFunctionType setter;
+  };
+
+  // Define a class whose methods and accessors live on a prototype shared by
+  // all of its instances, rather than being looked up through a host object
+  // on every access. Instances are created with createHostInstance() and
+  // carry their native state, which members reach through their receiver.
+  // Members reject receivers that aren't instances of their own class.
+  //
+  // Members may be detached from the prototype and outlive the constructor,
+  // so a host class lives until the runtime is destroyed. Define classes once
+  // per runtime rather than per request or module.
+  jsi::Function
+  createHostClass(const jsi::PropNameID &name, std::vector<JSIHostMethod> methods, std::vector<JSIHostAccessor> accessors = {}) {
+    int err;
+
+    auto ref = std::make_unique<JSIHostClassReference>();
+
+    std::vector<js_property_descriptor_t> properties;
+
+    properties.reserve(methods.size() + accessors.size());
+
+    auto key = [&] (const std::string &name) {
+      js_value_t *result;
+      err = js_create_string_utf8(env, reinterpret_cast<const utf8_t *>(name.data()), name.length(), &result);
+      if (err < 0) throw lastException();
+
+      return result;
+    };
+
+    for (auto &method : methods) {
+      properties.push_back({
+        .version = 0,
+        .name = key(method.name),
+        .data = ref->methods.emplace_back(std::make_unique<JSIHostMemberReference>(*this, ref.get(), std::move(method.function))).get(),
+        .attributes = js_writable | js_configurable,
+        .method = trampoline<JSIHostMemberReference>(method.paramCount),
+      });
+    }
+
+    for (auto &accessor : accessors) {
+      auto &members = ref->accessors.emplace_back(std::make_unique<JSIHostAccessorReference>());
+
+      if (accessor.getter) members->getter = std::make_unique<JSIHostMemberReference>(*this, ref.get(), std::move(accessor.getter));
+      if (accessor.setter) members->setter = std::make_unique<JSIHostMemberReference>(*this, ref.get(), std::move(accessor.setter));
+
+      properties.push_back({
+        .version = 0,
+        .name = key(accessor.name),
+        .data = members.get(),
+        .attributes = js_configurable,
+        .getter = members->getter ? JSIHostAccessorReference::get : nullptr,
+        .setter = members->setter ? JSIHostAccessorReference::set : nullptr,
+      });
+    }
+
+    auto str = as<JSIPointerValue>(name)->toString(*this);
+
+    js_value_t *result;
+    err = js_define_class(env, str.data(), str.length(), JSIHostClassReference::construct, ref.get(), properties.data(), properties.size(), &result);
+    if (err < 0) throw lastException();
+
+    err = js_wrap(env, result, ref.get(), nullptr, nullptr, nullptr);
+    if (err < 0) throw lastException();
+
+    err = js_add_type_tag(env, result, &JSIHostClassReference::tag);
+    assert(err == 0);
+
+    host_classes.push_back(std::move(ref));
+
+    return make<jsi::Function>(result, JSIAllKinds, JSIFunctionKind);
+  }
+
+  jsi::Object
+  createHostInstance(const jsi::Function &constructor, std::shared_ptr<jsi::NativeState> state) {
+    int err;
+
+    bool valid;
+    err = js_check_type_tag(env, as(constructor), &JSIHostClassReference::tag, &valid);
+    assert(err == 0);
+
+    if (!valid) throw jsi::JSINativeException("Constructor is not a host class");
+
+    JSIHostClassReference *owner;
+    err = js_unwrap(env, as(constructor), reinterpret_cast<void **>(&owner));
+    assert(err == 0);
+
+    js_value_t *result;
+    err = js_new_instance(env, as(constructor), 0, nullptr, &result);
+    if (err < 0) throw lastException();
+
+    auto ref = new JSINativeStateReference(std::move(state), owner);
+
+    err = js_wrap(env, result, ref, finalize<JSINativeStateReference>, ref, nullptr);
+    if (err < 0) throw lastException();
+
+    err = js_add_type_tag(env, result, &JSINativeStateReference::tag);
+    assert(err == 0);
+
+    return make<jsi::Object>(result, JSIAllKinds, 0);
+  }
+
+  // Keep the keys of a host object between enumerations rather than asking
+  // it for its property names every time. The host is responsible for
+  // calling invalidateHostObjectKeys() whenever its keys change.
+  void
+  setHostObjectKeysCached(const jsi::Object &object, bool cached) {
+    auto ref = hostObjectReference(object);
+
+    ref->cache_keys = cached;
+
+    if (!cached) ref->invalidate();
+  }
+
+  void
+  invalidateHostObjectKeys(const jsi::Object &object) {
+    hostObjectReference(object)->invalidate();
+  }
+
+  // The properties of host objects of type T, registered up front. Names are
+  // interned on registration. On each access the name is read to look up
+  // its atom, which then indexes the table, so it isn't compared against each
+  // entry. Names up to 64 bytes are read into a stack buffer. Only hosts
+  // deriving from JSIHostObject with atoms enabled, such as
+  // JSIStaticHostObject, are passed atoms. Methods are created once per table
+  // and the same function is returned on every access; they find the host
+  // object through their receiver. A table must not outlive its runtime.
+  template <typename T>
+  struct JSIHostObjectTable {
+    using getter_type = jsi::Value (*)(jsi::Runtime &runtime, T &object);
+    using setter_type = void (*)(jsi::Runtime &runtime, T &object, const jsi::Value &value);
+    using method_type = jsi::Value (*)(jsi::Runtime &runtime, T &object, const jsi::Value *args, size_t count);
+
+    JSIHostObjectTable(JSIRuntime &runtime)
+        : runtime(runtime) {}
+
+    JSIHostObjectTable(const JSIHostObjectTable &) = delete;
+
+    JSIHostObjectTable &
+    operator=(const JSIHostObjectTable &) = delete;
+
+    JSIHostObjectTable &
+    property(std::string_view name, getter_type getter, setter_type setter = nullptr) {
+      auto &entry = define(name);
+
+      entry.getter = getter;
+      entry.setter = setter;
+
+      return *this;
+    }
+
+    JSIHostObjectTable &
+    method(std::string_view name, unsigned int paramCount, method_type method) {
+      auto &entry = define(name);
+
+      entry.function = runtime.createFunctionFromCallable(runtime.interned(entry.atom), paramCount, [method] (jsi::Runtime &rt, const jsi::Value &receiver, const jsi::Value *args, size_t count) -> jsi::Value {
+        return method(rt, self(rt, receiver), args, count);
+      });
+
+      return *this;
+    }
+
+    // Look up a property, returning false if it isn't in the table.
+    bool
+    get(T &object, const jsi::PropNameID &name, jsi::Value &result) {
+      auto entry = find(name);
+
+      if (entry == nullptr) return false;
+
+      if (entry->getter) result = entry->getter(runtime, object);
+      else result = jsi::Value(runtime, entry->function);
+
+      return true;
+    }
+
+    bool
+    has(const jsi::PropNameID &name) {
+      return find(name) != nullptr;
+    }
+
+    // Assign a property, returning false if it isn't in the table or is
+    // read-only.
+    bool
+    set(T &object, const jsi::PropNameID &name, const jsi::Value &value) {
+      auto entry = find(name);
+
+      if (entry == nullptr || entry->setter == nullptr) return false;
+
+      entry->setter(runtime, object, value);
+
+      return true;
+    }
+
+    std::vector<jsi::PropNameID>
+    propertyNames() const {
+      std::vector<jsi::PropNameID> result;
+
+      result.reserve(atoms.size());
+
+      for (auto atom : atoms) {
+        result.emplace_back(runtime, runtime.interned(atom));
+      }
+
+      return result;
+    }
+
+  private:
+    struct JSIEntry {
+      uint32_t atom = 0;
+      getter_type getter = nullptr;
+      setter_type setter = nullptr;
+      jsi::Value function;
+    };
+
+    JSIRuntime &runtime;
+    std::vector<JSIEntry> entries;
+    std::vector<uint32_t> atoms;
+
+    JSIEntry &
+    define(std::string_view name) {
+      auto atom = runtime.intern(name);
+
+      if (atom >= entries.size()) entries.resize(atom + 1);
+
+      auto &entry = entries[atom];
+
+      if (entry.atom == 0) {
+        entry.atom = atom;
+
+        atoms.push_back(atom);
+      }
+
+      entry.getter = nullptr;
+      entry.setter = nullptr;
+      entry.function = jsi::Value::undefined();
+
+      return entry;
+    }
+
+    inline JSIEntry *
+    find(const jsi::PropNameID &name) {
+      auto atom = runtime.atom(name);
+
+      if (atom == 0 || atom >= entries.size() || entries[atom].atom == 0) return nullptr;
+
+      return &entries[atom];
+    }
+
+    static T &
+    self(jsi::Runtime &rt, const jsi::Value &receiver) {
+      auto &runtime = static_cast<JSIRuntime &>(rt);
+
+      if (receiver.isObject()) {
+        auto object = receiver.getObject(rt);
+
+        if (runtime.isHostObject(object)) {
+          auto result = dynamic_cast<T *>(runtime.getHostObject(object).get());
+
+          if (result) return *result;
+        }
+      }
+
+      // Thrown as a TypeError to match the receiver check of host class
+      // members.
+      auto error = rt.global()
+                     .getPropertyAsFunction(rt, "TypeError")
+                     .callAsConstructor(rt, "Illegal invocation");
+
+      throw jsi::JSError(rt, std::move(error));
+    }
+  };
+
+  // A host object whose properties are dispatched through a shared
+  // JSIHostObjectTable. Properties missing from the table read as undefined,
+  // can't be assigned and aren't reported by `in`.
+  template <typename T>
+  struct JSIStaticHostObject : JSIHostObject {
+    std::shared_ptr<JSIHostObjectTable<T>> table;
+
+    JSIStaticHostObject(std::shared_ptr<JSIHostObjectTable<T>> table)
+        : JSIHostObject(true),
+          table(std::move(table)) {}
+
+    jsi::Value
+    get(jsi::Runtime &runtime, const jsi::PropNameID &name) override {
+      jsi::Value result;
+
+      table->get(static_cast<T &>(*this), name, result);
+
+      return result;
+    }
+
+    void
+    set(jsi::Runtime &runtime, const jsi::PropNameID &name, const jsi::Value &value) override {
+      if (!table->set(static_cast<T &>(*this), name, value)) jsi::HostObject::set(runtime, name, value);
+    }
+
+    bool
+    has(jsi::Runtime &runtime, const jsi::PropNameID &name) override {
+      return table->has(name);
+    }
+
+    std::vector<jsi::PropNameID>
+    getPropertyNames(jsi::Runtime &runtime) override {
+      return table->propertyNames();
+    }
+  };
+
+  // Create a function from a native callable whose signature is deduced at
+  // compile time. Arguments and the return value are converted directly
+  // between engine values and bool, double, int32_t, uint32_t, int64_t,
+  // std::string, std::string_view, std::span<uint8_t> (an ArrayBuffer,
+  // borrowed for the duration of the call) and jsi::Value. Calls with too few
+  // arguments, or arguments of the wrong type, throw a TypeError.
+  //
+  // Callables that are declared noexcept and only take and return bool,
+  // double, int32_t and uint32_t are also registered with the engine's fast
+  // call path, letting optimized code call them directly. The engine falls
+  // back to the generic callback whenever the arguments don't match.
+  template <typename F>
+  jsi::Function
+  createTypedFunction(const jsi::PropNameID &name, F function) {
+    int err;
+
+    using JSITypedFunctionReference = typename JSITypedSignature<F>::template reference<F>;
+
+    auto ref = new JSITypedFunctionReference(*this, std::move(function));
+
+    auto str = as<JSIPointerValue>(name)->toString(*this);
+
+    js_value_t *result;
+
+    if constexpr (JSITypedFunctionReference::fast) {
+      err = js_create_typed_function(env, str.data(), str.length(), JSITypedFunctionReference::call, &JSITypedFunctionReference::signature, reinterpret_cast<const void *>(JSITypedFunctionReference::fastCall), ref, &result);
+    } else {
+      err = js_create_function(env, str.data(), str.length(), JSITypedFunctionReference::call, ref, &result);
+    }
+
+    if (err < 0) throw lastException();
+
+    err = js_wrap(env, result, ref, finalize<JSITypedFunctionReference>, ref, nullptr);
+    assert(err == 0);
+
+    return make<jsi::Function>(result, JSIAllKinds, JSIFunctionKind);
+  }
+
+protected:
+  PointerValue *
+  cloneSymbol(const PointerValue *pv) override {
+    return JSIPointerValue::clone(as<JSIPointerValue>(pv));
+  }
+
+  PointerValue *
+  cloneBigInt(const PointerValue *pv) override {
+    return JSIPointerValue::clone(as<JSIPointerValue>(pv));
+  }
+
+  PointerValue *
+  cloneString(const PointerValue *pv) override {
+    return JSIPointerValue::clone(as<JSIPointerValue>(pv));
+  }
+
+  PointerValue *
+  cloneObject(const PointerValue *pv) override {
+    return JSIPointerValue::clone(as<JSIPointerValue>(pv));
+  }
+
+  PointerValue *
+  clonePropNameID(const PointerValue *pv) override {
+    return JSIPointerValue::clone(as<JSIPointerValue>(pv));
+  }
+
+  jsi::PropNameID
+  createPropNameIDFromAscii(const char *str, size_t len) override {
+    int err;
+
+    js_value_t *value;
+    err = js_create_string_utf8(env, reinterpret_cast<const utf8_t *>(str), len, &value);
+    if (err < 0) throw lastException();
+
+    return make<jsi::PropNameID>(value);
+  }
+
+  jsi::PropNameID
+  createPropNameIDFromUtf8(const uint8_t *str, size_t len) override {
+    int err;
+
+    js_value_t *value;
+    err = js_create_string_utf8(env, str, len, &value);
+    if (err < 0) throw lastException();
+
+    return make<jsi::PropNameID>(value);
+  }
+
+  jsi::PropNameID
+  createPropNameIDFromString(const jsi::String &str) override {
+    return Runtime::make<jsi::PropNameID>(cloneString(getPointerValue(str)));
+  }
+
+  jsi::PropNameID
+  createPropNameIDFromSymbol(const jsi::Symbol &sym) override {
+    return Runtime::make<jsi::PropNameID>(cloneSymbol(getPointerValue(sym)));
+  }
+
+  std::string
+  utf8(const jsi::PropNameID &prop) override {
+    auto pv = as<JSIPointerValue>(prop);
+
+    if (pv->atom) return *atom_names[pv->atom - 1];
+
+    return pv->toString(*this);
+  }
+
+  bool
+  compare(const jsi::PropNameID &a, const jsi::PropNameID &b) override {
+    auto pa = as<JSIPointerValue>(a);
+    auto pb = as<JSIPointerValue>(b);
+
+    if (pa == pb) return true;
+
+    if (pa->atom && pb->atom) return false;
+
+    return strictEquals(static_cast<const jsi::Pointer &>(a), b);
+  }
+
+  std::string
+  symbolToString(const jsi::Symbol &sym) override {
+    return global()
+      .getPropertyAsFunction(*this, "String")
+      .call(*this, jsi::Value(*this, sym))
+      .asString(*this)
+      .utf8(*this);
+  }
+
+  jsi::BigInt
+  createBigIntFromInt64(int64_t n) override {
+    int err;
+
+    js_value_t *value;
+    err = js_create_bigint_int64(env, n, &value);
+    if (err < 0) throw lastException();
+
+    return make<jsi::BigInt>(value);
+  }
+
+  jsi::BigInt
+  createBigIntFromUint64(uint64_t n) override {
+    int err;
+
+    js_value_t *value;
+    err = js_create_bigint_uint64(env, n, &value);
+    if (err < 0) throw lastException();
+
+    return make<jsi::BigInt>(value);
+  }
+
+  bool
+  bigintIsInt64(const jsi::BigInt &bigint) override {
+    int err;
+
+    bool lossless;
+    err = js_get_value_bigint_int64(env, as(bigint), nullptr, &lossless);
+    if (err < 0) throw lastException();
+
+    return lossless;
+  }
+
+  bool
+  bigintIsUint64(const jsi::BigInt &bigint) override {
+    int err;
+
+    bool lossless;
+    err = js_get_value_bigint_uint64(env, as(bigint), nullptr, &lossless);
+    if (err < 0) throw lastException();
+
+    return lossless;
+  }
+
+  uint64_t
+  truncate(const jsi::BigInt &bigint) override {
+    int err;
+
+    uint64_t value;
+    err = js_get_value_bigint_uint64(env, as(bigint), &value, nullptr);
+    if (err < 0) throw lastException();
+
+    return value;
+  }
+
+  jsi::String
+  bigintToString(const jsi::BigInt &bigint, int radix) override {
+    return global()
+      .getPropertyAsFunction(*this, "String")
+      .call(*this, jsi::Value(*this, bigint))
+      .asString(*this);
+  }
+
+  jsi::String
+  createStringFromAscii(const char *str, size_t len) override {
+    int err;
+
+    js_value_t *value;
+    err = js_create_string_utf8(env, reinterpret_cast<const utf8_t *>(str), len, &value);
+    if (err < 0) throw lastException();
+
+    return make<jsi::String>(value);
+  }
+
+  jsi::String
+  createStringFromUtf8(const uint8_t *str, size_t len) override {
+    int err;
+
+    js_value_t *value;
+    err = js_create_string_utf8(env, str, len, &value);
+    if (err < 0) throw lastException();
+
+    return make<jsi::String>(value);
+  }
+
+  std::string
+  utf8(const jsi::String &string) override {
+    return as<JSIPointerValue>(string)->toString(*this);
+  }
+
+  jsi::Value
+  createValueFromJsonUtf8(const uint8_t *json, size_t length) override {
+    return global()
+      .getPropertyAsObject(*this, "JSON")
+      .getPropertyAsFunction(*this, "parse")
+      .call(*this, jsi::String::createFromUtf8(*this, json, length));
+  }
+
+  jsi::Object
+  createObject() override {
+    int err;
+
+    js_value_t *result;
+    err = js_create_object(env, &result);
+    if (err < 0) throw lastException();
+
+    return make<jsi::Object>(result, JSIAllKinds, 0);
+  }
+
+  jsi::Object
+  createObject(std::shared_ptr<jsi::HostObject> object) override {
+    int err;
+
+    auto ref = new JSIHostObjectReference(*this, std::move(object));
+
+    js_delegate_callbacks_t callbacks = {
+      .get = JSIHostObjectReference::get,
+      .has = ref->hooks ? JSIHostObjectReference::has : nullptr,
+      .set = JSIHostObjectReference::set,
+      .delete_property = ref->hooks ? JSIHostObjectReference::deleteProperty : nullptr,
+      .own_keys = JSIHostObjectReference::ownKeys,
+    };
+
+    js_value_t *result;
+    err = js_create_delegate(env, &callbacks, ref, finalize<JSIHostObjectReference>, ref, &result);
+    if (err < 0) throw lastException();
+
+    err = js_wrap(env, result, ref, nullptr, nullptr, nullptr);
+    assert(err == 0);
+
+    err = js_add_type_tag(env, result, &JSIHostObjectReference::tag);
+    assert(err == 0);
+
+    return make<jsi::Object>(result, JSIAllKinds, JSIHostObjectKind);
+  }
+
+  std::shared_ptr<jsi::HostObject>
+  getHostObject(const jsi::Object &object) override {
+    return hostObjectReference(object)->object;
+  }
+
+  jsi::HostFunctionType &
+  getHostFunction(const jsi::Function &function) override {
+    int err;
+
+    JSIHostFunctionReference *ref;
+    err = js_unwrap(env, as(function), reinterpret_cast<void **>(&ref));
+    assert(err == 0);
 
     return ref->function;
   }
 
   bool
-  hasNativeState(const jsi::Object &object) override {
+  hasNativeState(const jsi::Object &object) override {
+    int err;
+
+    bool result;
+    err = js_check_type_tag(env, as(object), &JSINativeStateReference::tag, &result);
+    assert(err == 0);
+
+    return result;
+  }
+
+  std::shared_ptr<jsi::NativeState>
+  getNativeState(const jsi::Object &object) override {
+    int err;
+
+    JSINativeStateReference *ref;
+    err = js_unwrap(env, as(object), reinterpret_cast<void **>(&ref));
+    assert(err == 0);
+
+    return ref->state;
+  }
+
+  void
+  setNativeState(const jsi::Object &object, std::shared_ptr<jsi::NativeState> state) override {
+    int err;
+
+    auto ref = new JSINativeStateReference(std::move(state));
+
+    auto result = as(object);
+
+    err = js_wrap(env, result, ref, finalize<JSINativeStateReference>, ref, nullptr);
+    if (err < 0) throw lastException();
+
+    err = js_add_type_tag(env, result, &JSINativeStateReference::tag);
+    assert(err == 0);
+  }
+
+  jsi::Value
+  getProperty(const jsi::Object &object, const jsi::PropNameID &key) override {
+    return unwrap(tryGetProperty(object, key));
+  }
+
+  jsi::Value
+  getProperty(const jsi::Object &object, const jsi::String &key) override {
+    return unwrap(tryGetProperty(object, key));
+  }
+
+  bool
+  hasProperty(const jsi::Object &object, const jsi::PropNameID &key) override {
+    int err;
+
+    bool result;
+    err = js_has_property(env, as(object), as(key), &result);
+    if (err < 0) throw lastException();
+
+    return result;
+  }
+
+  bool
+  hasProperty(const jsi::Object &object, const jsi::String &key) override {
+    int err;
+
+    bool result;
+    err = js_has_property(env, as(object), as(key), &result);
+    if (err < 0) throw lastException();
+
+    return result;
+  }
+
+  void
+  setPropertyValue(const jsi::Object &object, const jsi::PropNameID &key, const jsi::Value &value) override {
+    int err;
+
+    bool result;
+    err = js_set_property(env, as(object), as(key), as(value));
+    if (err < 0) throw lastException();
+  }
+
+  void
+  setPropertyValue(const jsi::Object &object, const jsi::String &key, const jsi::Value &value) override {
+    int err;
+
+    bool result;
+    err = js_set_property(env, as(object), as(key), as(value));
+    if (err < 0) throw lastException();
+  }
+
+  bool
+  isArray(const jsi::Object &object) const override {
+    return resolve(as<JSIPointerValue>(object), JSIArrayKind);
+  }
+
+  bool
+  isArrayBuffer(const jsi::Object &object) const override {
+    return resolve(as<JSIPointerValue>(object), JSIArrayBufferKind);
+  }
+
+  bool
+  isFunction(const jsi::Object &object) const override {
+    return resolve(as<JSIPointerValue>(object), JSIFunctionKind);
+  }
+
+  bool
+  isHostObject(const jsi::Object &object) const override {
+    return resolve(as<JSIPointerValue>(object), JSIHostObjectKind);
+  }
+
+  bool
+  isHostFunction(const jsi::Function &function) const override {
+    return resolve(as<JSIPointerValue>(function), JSIHostFunctionKind);
+  }
+
+  jsi::Array
+  getPropertyNames(const jsi::Object &object) override {
+    int err;
+
+    js_value_t *value;
+    err = js_get_property_names(env, as(object), &value);
+    if (err < 0) throw lastException();
+
+    return make<jsi::Array>(value, JSIAllKinds, JSIArrayKind);
+  }
+
+  jsi::WeakObject
+  createWeakObject(const jsi::Object &object) override {
+    return make<jsi::WeakObject>(as(object));
+  }
+
+  jsi::Value
+  lockWeakObject(const jsi::WeakObject &object) override {
+    return make<jsi::Object>(as<JSIWeakPointerValue>(object)->value());
+  }
+
+  jsi::Array
+  createArray(size_t len) override {
+    int err;
+
+    js_value_t *value;
+    err = js_create_array_with_length(env, len, &value);
+    if (err < 0) throw lastException();
+
+    return make<jsi::Array>(value, JSIAllKinds, JSIArrayKind);
+  }
+
+  jsi::ArrayBuffer
+  createArrayBuffer(std::shared_ptr<jsi::MutableBuffer> buffer) override {
+    int err;
+
+    auto ref = new JSIArrayBufferReference(std::move(buffer));
+
+    js_value_t *value;
+    err = js_create_external_arraybuffer(env, ref->buffer->data(), ref->buffer->size(), finalize<JSIArrayBufferReference>, ref, &value);
+    if (err < 0) throw lastException();
+
+    return make<jsi::ArrayBuffer>(value, JSIAllKinds, JSIArrayBufferKind);
+  }
+
+  size_t
+  size(const jsi::Array &array) override {
+    int err;
+
+    uint32_t len;
+    err = js_get_array_length(env, as(array), &len);
+    if (err < 0) throw lastException();
+
+    return len;
+  }
+
+  size_t
+  size(const jsi::ArrayBuffer &arraybuffer) override {
+    int err;
+
+    size_t len;
+    err = js_get_arraybuffer_info(env, as(arraybuffer), nullptr, &len);
+    if (err < 0) throw lastException();
+
+    return len;
+  }
+
+  uint8_t *
+  data(const jsi::ArrayBuffer &arraybuffer) override {
+    int err;
+
+    uint8_t *data;
+    err = js_get_arraybuffer_info(env, as(arraybuffer), reinterpret_cast<void **>(&data), nullptr);
+    if (err < 0) throw lastException();
+
+    return data;
+  }
+
+  jsi::Value
+  getValueAtIndex(const jsi::Array &array, size_t i) override {
+    int err;
+
+    js_value_t *value;
+    err = js_get_element(env, as(array), i, &value);
+    if (err < 0) throw lastException();
+
+    return as(value);
+  }
+
+  void
+  setValueAtIndexImpl(const jsi::Array &array, size_t i, const jsi::Value &value) override {
+    int err;
+
+    err = js_set_element(env, as(array), i, as(value));
+    if (err < 0) throw lastException();
+  }
+
+  jsi::Function
+  createFunctionFromHostFunction(const jsi::PropNameID &name, unsigned int argc, jsi::HostFunctionType function) override {
+    int err;
+
+    auto ref = new JSIHostFunctionReference(*this, std::move(function));
+
+    auto str = as<JSIPointerValue>(name)->toString(*this);
+
+    js_value_t *result;
+    err = js_create_function(env, str.data(), str.length(), trampoline<JSIHostFunctionReference>(argc), ref, &result);
+    if (err < 0) throw lastException();
+
+    err = js_wrap(env, result, ref, finalize<JSIHostFunctionReference>, ref, nullptr);
+    assert(err == 0);
+
+    err = js_add_type_tag(env, result, &JSIHostFunctionReference::tag);
+    assert(err == 0);
+
+    return make<jsi::Function>(result, JSIAllKinds, JSIFunctionKind | JSIHostFunctionKind);
+  }
+
+  jsi::Value
+  call(const jsi::Function &function, const jsi::Value &receiver, const jsi::Value *args, size_t count) override {
+    return unwrap(tryCall(function, receiver, args, count));
+  }
+
+  jsi::Value
+  callAsConstructor(const jsi::Function &constructor, const jsi::Value *args, size_t count) override {
+    return unwrap(tryCallAsConstructor(constructor, args, count));
+  }
+
+  ScopeState *
+  pushScope() override {
+    int err;
+
+    js_handle_scope_t *scope;
+    err = js_open_handle_scope(env, &scope);
+    if (err < 0) throw lastException();
+
+    return reinterpret_cast<ScopeState *>(&scopes.emplace_back(scope, ++scope_ids));
+  }
+
+  void
+  popScope(ScopeState *state) override {
+    int err;
+
+    auto scope = reinterpret_cast<JSIScope *>(state);
+
+    assert(scope == &scopes.back());
+
+    scope->promote();
+
+    err = js_close_handle_scope(env, scope->scope);
+    assert(err == 0);
+
+    scopes.pop_back();
+
+    flushReleases();
+  }
+
+  bool
+  strictEquals(const jsi::Symbol &a, const jsi::Symbol &b) const override {
+    return strictEquals(static_cast<const jsi::Pointer &>(a), b);
+  }
+
+  bool
+  strictEquals(const jsi::BigInt &a, const jsi::BigInt &b) const override {
+    return strictEquals(static_cast<const jsi::Pointer &>(a), b);
+  }
+
+  bool
+  strictEquals(const jsi::String &a, const jsi::String &b) const override {
+    return strictEquals(static_cast<const jsi::Pointer &>(a), b);
+  }
+
+  bool
+  strictEquals(const jsi::Object &a, const jsi::Object &b) const override {
+    return strictEquals(static_cast<const jsi::Pointer &>(a), b);
+  }
+
+  inline bool
+  strictEquals(const jsi::Pointer &a, const jsi::Pointer &b) const {
     int err;
 
     bool result;
-    err = js_check_type_tag(env, as(object), &JSINativeStateReference::tag, &result);
+    err = js_strict_equals(env, as(a), as(b), &result);
     assert(err == 0);
 
     return result;
   }
 
-  std::shared_ptr<jsi::NativeState>
-  getNativeState(const jsi::Object &object) override {
+  bool
+  instanceOf(const jsi::Object &object, const jsi::Function &constructor) override {
+    int err;
+
+    bool result;
+    err = js_instanceof(env, as(object), as(constructor), &result);
+    if (err < 0) throw lastException();
+
+    return result;
+  }
+
+  void
+  setExternalMemoryPressure(const jsi::Object &obj, size_t amount) override {}
+
+private:
+  struct JSIScope;
+  struct JSIPointerValue;
+  struct JSIDeferredRelease;
+  struct JSIHostObjectReference;
+  struct JSIHostClassReference;
+
+  enum JSIPrimitive {
+    JSIUndefined,
+    JSINull,
+    JSIFalse,
+    JSITrue,
+  };
+
+  std::deque<JSIScope> scopes;
+  uint64_t scope_ids = 0;
+  std::deque<jsi::Function> microtask_queue;
+  std::vector<js_value_t *> scratch_argv;
+  std::vector<js_ref_t *> release_queue;
+  size_t release_threshold = 256;
+  std::atomic<JSIDeferredRelease *> deferred_releases = nullptr;
+  std::atomic<bool> closing = false;
+  uv_async_t release_async;
+  uv_thread_t thread;
+  js_ref_t *batch_function = nullptr;
+  bool lazy_errors = false;
+  bool tearing_down = false;
+  std::vector<std::unique_ptr<JSIHostClassReference>> host_classes;
+
+  struct JSIAtomHash {
+    using is_transparent = void;
+
+    size_t
+    operator()(std::string_view key) const {
+      return std::hash<std::string_view>()(key);
+    }
+  };
+
+  // Property names are only interned when asked to, so the table never grows
+  // on its own. It's keyed by contents as handles to the same string differ
+  // between accesses. Names up to atom_length bytes are looked up from the
+  // stack, longer ones through a heap buffer.
+  static constexpr size_t atom_length = 64;
+
+  std::unordered_map<std::string, jsi::PropNameID, JSIAtomHash, std::equal_to<>> atoms;
+  std::vector<const std::string *> atom_names;
+
+  const jsi::PropNameID &
+  intern(std::string_view key, js_value_t *value) {
+    auto name = make<jsi::PropNameID>(value);
+
+    auto it = atoms.emplace(key, std::move(name)).first;
+
+    atom_names.push_back(&it->first);
+
+    as<JSIPointerValue>(it->second)->atom = atom_names.size();
+
+    return it->second;
+  }
+
+  inline JSIHostObjectReference *
+  hostObjectReference(const jsi::Object &object) {
+    int err;
+
+    JSIHostObjectReference *ref;
+    err = js_unwrap(env, as(object), reinterpret_cast<void **>(&ref));
+    assert(err == 0);
+
+    return ref;
+  }
+
+  inline const jsi::PropNameID &
+  interned(uint32_t atom) {
+    return atoms.find(*atom_names[atom - 1])->second;
+  }
+
+  const jsi::PropNameID *
+  interned(js_value_t *property) {
+    int err;
+
+    if (atoms.empty()) return nullptr;
+
+    js_value_type_t type;
+    err = js_typeof(env, property, &type);
+    assert(err == 0);
+
+    if (type != js_string) return nullptr;
+
+    size_t len;
+    err = js_get_value_string_utf8(env, property, nullptr, 0, &len);
+    assert(err == 0);
+
+    char buffer[atom_length];
+
+    std::string overflow;
+
+    char *key = buffer;
+
+    if (len > atom_length) {
+      overflow.resize(len);
+
+      key = overflow.data();
+    }
+
+    err = js_get_value_string_utf8(env, property, reinterpret_cast<utf8_t *>(key), len, nullptr);
+    assert(err == 0);
+
+    auto it = atoms.find(std::string_view(key, len));
+
+    if (it == atoms.end()) return nullptr;
+
+    return &it->second;
+  }
+
+  // The loop driving callBatch(), compiled on first use. Reflect.apply is
+  // captured when the loop is compiled and the arguments are indexed
+  // directly, so globals patched later by user code aren't involved. Thrown
+  // values are stored in place of the result and their indices collected
+  // separately.
+  js_value_t *
+  batchFunction() {
+    int err;
+
+    js_value_t *result;
+
+    if (batch_function) {
+      err = js_get_reference_value(env, batch_function, &result);
+      assert(err == 0);
+
+      return result;
+    }
+
+    static const char source[] =
+      "((apply) => function (fn, self, args, arity, results, errors) {"
+      "  for (let i = 0, n = results.length; i < n; i++) {"
+      "    const argv = [];"
+      "    for (let j = 0; j < arity; j++) argv[j] = args[i * arity + j];"
+      "    try {"
+      "      results[i] = apply(fn, self, argv)"
+      "    } catch (err) {"
+      "      results[i] = err;"
+      "      errors[errors.length] = i"
+      "    }"
+      "  }"
+      "})(Reflect.apply)";
+
+    js_value_t *script;
+    err = js_create_string_utf8(env, reinterpret_cast<const utf8_t *>(source), sizeof(source) - 1, &script);
+    if (err < 0) throw lastException();
+
+    static const char file[] = "jsi:batch";
+
+    err = js_run_script(env, file, sizeof(file) - 1, 0, script, &result);
+    if (err < 0) throw lastException();
+
+    err = js_create_reference(env, result, 1, &batch_function);
+    assert(err == 0);
+
+    return result;
+  }
+
+  inline bool
+  isCurrentThread() const {
+    auto self = uv_thread_self();
+
+    return uv_thread_equal(&thread, &self);
+  }
+
+  // Pointer values may be invalidated on any thread, such as when a host
+  // object holding them is released from a worker. Those invalidations are
+  // pushed onto a lock-free stack and replayed on the JavaScript thread when
+  // a scope is popped, when flushReleases() is called or when the loop of
+  // the runtime is run. Other threads must be done with their values before
+  // the runtime starts being destroyed.
+  inline void
+  defer(PointerValue *value) noexcept {
+    assert(!closing.load(std::memory_order_relaxed));
+
+    auto deferred = new (std::nothrow) JSIDeferredRelease(value, deferred_releases.load(std::memory_order_relaxed));
+
+    // Invalidation can't fail, so if the node can't be allocated the value
+    // is leaked rather than invalidated on the wrong thread.
+    if (deferred == nullptr) return;
+
+    while (!deferred_releases.compare_exchange_weak(deferred->next, deferred, std::memory_order_release, std::memory_order_relaxed)) {
+    }
+
+    if (!closing.load(std::memory_order_acquire)) uv_async_send(&release_async);
+  }
+
+  static void
+  onrelease(uv_async_t *handle) {
+    auto runtime = static_cast<JSIRuntime *>(handle->data);
+
+    runtime->flushReleases();
+  }
+
+  // References are queued and deleted in batches, except while the
+  // environment is being torn down when nothing would flush the queue
+  // again. A release from within a finalizer never flushes, as the engine
+  // may be in the middle of collecting garbage.
+  inline void
+  release(js_ref_t *ref) {
+    int err;
+
+    if (tearing_down) {
+      err = js_delete_reference(env, ref);
+      assert(err == 0);
+
+      return;
+    }
+
+    release_queue.push_back(ref);
+
+    if (release_queue.size() >= release_threshold && finalizing == 0) flushReleases();
+  }
+
+  static inline thread_local int finalizing = 0;
+
+  template <typename T>
+  static void
+  finalize(js_env_t *, void *data, void *finalize_hint) {
+    finalizing++;
+
+    delete static_cast<T *>(finalize_hint);
+
+    finalizing--;
+  }
+
+  static inline bool
+  isInt32(double number) {
+    return number >= INT32_MIN && number <= INT32_MAX && number == static_cast<int32_t>(number) && (number != 0 || !std::signbit(number));
+  }
+
+  static inline bool
+  isUint32(double number) {
+    return number >= 0 && number <= UINT32_MAX && number == static_cast<uint32_t>(number) && !std::signbit(number);
+  }
+
+  template <typename T>
+  inline T
+  make(js_value_t *value, uint8_t resolved = 0, uint8_t kinds = 0) {
+    if constexpr (std::is_same_v<T, jsi::WeakObject>) {
+      return Runtime::make<T>(weak_pointer_values.alloc(value));
+    } else {
+      auto pv = scopes.empty() ? pointer_values.alloc(value) : pointer_values.alloc(scopes.back(), value);
+
+      pv->resolved = resolved;
+      pv->kinds = kinds;
+
+      return Runtime::make<T>(pv);
+    }
+  }
+
+  inline uint8_t
+  resolve(const JSIPointerValue *pv, uint8_t mask) const {
     int err;
 
-    JSINativeStateReference *ref;
-    err = js_unwrap(env, as(object), reinterpret_cast<void **>(&ref));
-    assert(err == 0);
+    js_value_t *value = nullptr;
+
+    for (uint8_t kind : {JSIFunctionKind, JSIArrayKind, JSIArrayBufferKind, JSIHostObjectKind, JSIHostFunctionKind}) {
+      if ((mask & kind) == 0 || (pv->resolved & kind) != 0) continue;
+
+      if (value == nullptr) value = pv->value();
+
+      bool result;
+
+      switch (kind) {
+      case JSIFunctionKind:
+        err = js_is_function(env, value, &result);
+        break;
+
+      case JSIArrayKind:
+        err = js_is_array(env, value, &result);
+        break;
+
+      case JSIArrayBufferKind:
+        err = js_is_arraybuffer(env, value, &result);
+        break;
+
+      case JSIHostObjectKind:
+        err = js_check_type_tag(env, value, &JSIHostObjectReference::tag, &result);
+        break;
 
-    return ref->state;
-  }
+      case JSIHostFunctionKind:
+        err = js_check_type_tag(env, value, &JSIHostFunctionReference::tag, &result);
+        break;
 
-  void
-  setNativeState(const jsi::Object &object, std::shared_ptr<jsi::NativeState> state) override {
-    int err;
+      default:
+        assert(false);
+        continue;
+      }
 
-    auto ref = new JSINativeStateReference(std::move(state));
+      assert(err == 0);
 
-    auto result = as(object);
+      pv->learn(kind, result);
+    }
 
-    err = js_wrap(env, result, ref, finalize<JSINativeStateReference>, ref, nullptr);
-    if (err < 0) throw lastException();
+    return pv->kinds & mask;
+  }
 
-    err = js_add_type_tag(env, result, &JSINativeStateReference::tag);
-    assert(err == 0);
+  template <typename T>
+  inline const T *
+  as(const jsi::Pointer &p) const {
+    return as<T>(getPointerValue(p));
   }
 
-  jsi::Value
-  getProperty(const jsi::Object &object, const jsi::PropNameID &key) override {
-    int err;
+  template <typename T>
+  inline const T *
+  as(const PointerValue *pv) const {
+    return static_cast<const T *>(pv);
+  }
 
-    js_value_t *value;
-    err = js_get_property(env, as(object), as(key), &value);
-    if (err < 0) throw lastException();
+  inline js_value_t *
+  as(const jsi::Pointer &p) const {
+    return as(getPointerValue(p));
+  }
 
-    return as(value);
+  inline js_value_t *
+  as(const PointerValue *pv) const {
+    return as<JSIPointerValue>(pv)->value();
   }
 
-  jsi::Value
-  getProperty(const jsi::Object &object, const jsi::String &key) override {
+  inline js_value_t *
+  as(const jsi::Value &v) {
     int err;
 
     js_value_t *value;
-    err = js_get_property(env, as(object), as(key), &value);
-    if (err < 0) throw lastException();
 
-    return as(value);
-  }
+    if (v.isUndefined()) return as(JSIUndefined);
 
-  bool
-  hasProperty(const jsi::Object &object, const jsi::PropNameID &key) override {
-    int err;
+    if (v.isNull()) return as(JSINull);
 
-    bool result;
-    err = js_has_property(env, as(object), as(key), &result);
-    if (err < 0) throw lastException();
+    if (v.isBool()) return as(v.getBool() ? JSITrue : JSIFalse);
 
-    return result;
-  }
+    if (v.isNumber()) {
+      auto number = v.getNumber();
+
+      if (isInt32(number)) {
+        err = js_create_int32(env, static_cast<int32_t>(number), &value);
+      } else if (isUint32(number)) {
+        err = js_create_uint32(env, static_cast<uint32_t>(number), &value);
+      } else {
+        err = js_create_double(env, number, &value);
+      }
 
-  bool
-  hasProperty(const jsi::Object &object, const jsi::String &key) override {
-    int err;
+      assert(err == 0);
 
-    bool result;
-    err = js_has_property(env, as(object), as(key), &result);
-    if (err < 0) throw lastException();
+      return value;
+    }
 
-    return result;
+    return as<JSIPointerValue>(getPointerValue(v))->value();
   }
 
-  void
-  setPropertyValue(const jsi::Object &object, const jsi::PropNameID &key, const jsi::Value &value) override {
+  inline js_value_t *
+  as(JSIPrimitive primitive) {
     int err;
 
-    bool result;
-    err = js_set_property(env, as(object), as(key), as(value));
-    if (err < 0) throw lastException();
-  }
+    js_value_t *value = nullptr;
 
-  void
-  setPropertyValue(const jsi::Object &object, const jsi::String &key, const jsi::Value &value) override {
-    int err;
+    auto cache = scopes.empty() ? &value : &scopes.back().primitives[primitive];
 
-    bool result;
-    err = js_set_property(env, as(object), as(key), as(value));
-    if (err < 0) throw lastException();
-  }
+    if (*cache) return *cache;
 
-  bool
-  isArray(const jsi::Object &object) const override {
-    int err;
+    switch (primitive) {
+    case JSIUndefined:
+      err = js_get_undefined(env, cache);
+      break;
+
+    case JSINull:
+      err = js_get_null(env, cache);
+      break;
+
+    case JSIFalse:
+    case JSITrue:
+      err = js_get_boolean(env, primitive == JSITrue, cache);
+      break;
+    }
 
-    bool result;
-    err = js_is_array(env, as(object), &result);
     assert(err == 0);
 
-    return result;
+    return *cache;
   }
 
-  bool
-  isArrayBuffer(const jsi::Object &object) const override {
+  inline js_value_t *
+  as(const jsi::JSError &err) {
+    return as(err.value());
+  }
+
+  jsi::Value
+  as(js_value_t *v) {
     int err;
 
-    bool result;
-    err = js_is_arraybuffer(env, as(object), &result);
+    if (!scopes.empty()) {
+      auto &primitives = scopes.back().primitives;
+
+      if (v == primitives[JSIUndefined]) return jsi::Value::undefined();
+      if (v == primitives[JSINull]) return jsi::Value::null();
+      if (v == primitives[JSIFalse]) return jsi::Value(false);
+      if (v == primitives[JSITrue]) return jsi::Value(true);
+    }
+
+    js_value_type_t type;
+    err = js_typeof(env, v, &type);
     assert(err == 0);
 
-    return result;
-  }
+    switch (type) {
+    case js_undefined:
+      return jsi::Value::undefined();
 
-  bool
-  isFunction(const jsi::Object &object) const override {
-    int err;
+    case js_null:
+    default:
+      return jsi::Value::null();
 
-    bool result;
-    err = js_is_function(env, as(object), &result);
-    assert(err == 0);
+    case js_boolean: {
+      bool value;
+      err = js_get_value_bool(env, v, &value);
+      assert(err == 0);
 
-    return result;
-  }
+      return jsi::Value(value);
+    }
 
-  bool
-  isHostObject(const jsi::Object &object) const override {
-    int err;
+    case js_number: {
+      double value;
+      err = js_get_value_double(env, v, &value);
+      assert(err == 0);
 
-    bool result;
-    err = js_check_type_tag(env, as(object), &JSIHostObjectReference::tag, &result);
-    assert(err == 0);
+      return jsi::Value(value);
+    }
 
-    return result;
-  }
+    case js_string:
+      return make<jsi::String>(v);
 
-  bool
-  isHostFunction(const jsi::Function &function) const override {
-    int err;
+    case js_symbol:
+      return make<jsi::Symbol>(v);
 
-    bool result;
-    err = js_check_type_tag(env, as(function), &JSIHostFunctionReference::tag, &result);
-    assert(err == 0);
+    case js_object:
+    case js_external:
+      return make<jsi::Object>(v, JSIFunctionKind | JSIHostFunctionKind, 0);
 
-    return result;
+    case js_function:
+      return make<jsi::Function>(v, JSIFunctionKind, JSIFunctionKind);
+
+    case js_bigint:
+      return make<jsi::BigInt>(v);
+    }
   }
 
-  jsi::Array
-  getPropertyNames(const jsi::Object &object) override {
+  inline JSIResult
+  pendingException() {
     int err;
 
-    js_value_t *value;
-    err = js_get_property_names(env, as(object), &value);
-    if (err < 0) throw lastException();
+    js_value_t *error;
+    err = js_get_and_clear_last_exception(env, &error);
+    assert(err == 0);
 
-    return make<jsi::Array>(value);
+    return {as(error), true};
   }
 
-  jsi::WeakObject
-  createWeakObject(const jsi::Object &object) override {
-    return make<jsi::WeakObject>(as(object));
-  }
+  inline jsi::Value
+  unwrap(JSIResult &&result) {
+    if (result.threw) throw JSIError(*this, std::move(result.value));
 
-  jsi::Value
-  lockWeakObject(const jsi::WeakObject &object) override {
-    return make<jsi::Object>(as(object));
+    return std::move(result.value);
   }
 
-  jsi::Array
-  createArray(size_t len) override {
+  inline JSIError
+  lastException() {
     int err;
 
-    js_value_t *value;
-    err = js_create_array_with_length(env, len, &value);
-    if (err < 0) throw lastException();
+    js_value_t *error;
+    err = js_get_and_clear_last_exception(env, &error);
+    assert(err == 0);
 
-    return make<jsi::Array>(value);
+    return JSIError(*this, as(error));
   }
 
-  jsi::ArrayBuffer
-  createArrayBuffer(std::shared_ptr<jsi::MutableBuffer> buffer) override {
+  bool
+  expect(js_value_t *value, js_value_type_t expected, const char *message) {
     int err;
 
-    auto ref = new JSIArrayBufferReference(std::move(buffer));
+    js_value_type_t type;
+    err = js_typeof(env, value, &type);
+    assert(err == 0);
 
-    js_value_t *value;
-    err = js_create_external_arraybuffer(env, ref->buffer->data(), ref->buffer->size(), finalize<JSIArrayBufferReference>, ref, &value);
-    if (err < 0) throw lastException();
+    if (type == expected) return true;
+
+    err = js_throw_type_error(env, NULL, message);
+    assert(err == 0);
 
-    return make<jsi::ArrayBuffer>(value);
+    return false;
   }
 
-  size_t
-  size(const jsi::Array &array) override {
+  bool
+  toNative(js_value_t *value, bool &result) {
     int err;
 
-    uint32_t len;
-    err = js_get_array_length(env, as(array), &len);
-    if (err < 0) throw lastException();
+    if (!expect(value, js_boolean, "Expected a boolean")) return false;
 
-    return len;
+    err = js_get_value_bool(env, value, &result);
+    assert(err == 0);
+
+    return true;
   }
 
-  size_t
-  size(const jsi::ArrayBuffer &arraybuffer) override {
+  bool
+  toNative(js_value_t *value, double &result) {
     int err;
 
-    size_t len;
-    err = js_get_arraybuffer_info(env, as(arraybuffer), nullptr, &len);
-    if (err < 0) throw lastException();
+    if (!expect(value, js_number, "Expected a number")) return false;
 
-    return len;
+    err = js_get_value_double(env, value, &result);
+    assert(err == 0);
+
+    return true;
   }
 
-  uint8_t *
-  data(const jsi::ArrayBuffer &arraybuffer) override {
+  bool
+  toNative(js_value_t *value, int32_t &result) {
     int err;
 
-    uint8_t *data;
-    err = js_get_arraybuffer_info(env, as(arraybuffer), reinterpret_cast<void **>(&data), nullptr);
-    if (err < 0) throw lastException();
+    if (!expect(value, js_number, "Expected a number")) return false;
 
-    return data;
+    err = js_get_value_int32(env, value, &result);
+    assert(err == 0);
+
+    return true;
   }
 
-  jsi::Value
-  getValueAtIndex(const jsi::Array &array, size_t i) override {
+  bool
+  toNative(js_value_t *value, uint32_t &result) {
     int err;
 
-    js_value_t *value;
-    err = js_get_element(env, as(array), i, &value);
-    if (err < 0) throw lastException();
+    if (!expect(value, js_number, "Expected a number")) return false;
 
-    return as(value);
+    err = js_get_value_uint32(env, value, &result);
+    assert(err == 0);
+
+    return true;
   }
 
-  void
-  setValueAtIndexImpl(const jsi::Array &array, size_t i, const jsi::Value &value) override {
+  bool
+  toNative(js_value_t *value, int64_t &result) {
     int err;
 
-    err = js_set_element(env, as(array), i, as(value));
-    if (err < 0) throw lastException();
-  }
+    if (!expect(value, js_number, "Expected a number")) return false;
 
-  jsi::Function
-  createFunctionFromHostFunction(const jsi::PropNameID &name, unsigned int argc, jsi::HostFunctionType function) override {
-    int err;
+    err = js_get_value_int64(env, value, &result);
+    assert(err == 0);
 
-    auto ref = new JSIHostFunctionReference(*this, function);
+    return true;
+  }
 
-    auto str = as<JSIPointerValue>(name)->toString(*this);
+  bool
+  toNative(js_value_t *value, std::string &result) {
+    int err;
 
-    js_value_t *result;
-    err = js_create_function(env, str.data(), str.length(), JSIHostFunctionReference::call, ref, &result);
-    if (err < 0) throw lastException();
+    if (!expect(value, js_string, "Expected a string")) return false;
 
-    err = js_wrap(env, result, ref, finalize<JSIHostFunctionReference>, ref, nullptr);
+    size_t len;
+    err = js_get_value_string_utf8(env, value, nullptr, 0, &len);
     assert(err == 0);
 
-    err = js_add_type_tag(env, result, &JSIHostFunctionReference::tag);
+    result.resize(len);
+
+    err = js_get_value_string_utf8(env, value, reinterpret_cast<utf8_t *>(result.data()), len, nullptr);
     assert(err == 0);
 
-    return make<jsi::Function>(result);
+    return true;
   }
 
-  jsi::Value
-  call(const jsi::Function &function, const jsi::Value &receiver, const jsi::Value *args, size_t count) override {
+  bool
+  toNative(js_value_t *value, std::span<uint8_t> &result) {
     int err;
 
-    std::vector<js_value_t *> argv;
+    bool is_arraybuffer;
+    err = js_is_arraybuffer(env, value, &is_arraybuffer);
+    assert(err == 0);
 
-    argv.reserve(count);
+    if (!is_arraybuffer) {
+      err = js_throw_type_error(env, NULL, "Expected an ArrayBuffer");
+      assert(err == 0);
 
-    for (size_t i = 0; i < count; i++) {
-      argv.push_back(as(args[i]));
+      return false;
     }
 
-    js_value_t *result;
-    err = js_call_function(env, as(receiver), as(function), count, argv.data(), &result);
-    if (err < 0) throw lastException();
+    void *data;
+    size_t len;
+    err = js_get_arraybuffer_info(env, value, &data, &len);
+    assert(err == 0);
 
-    return as(result);
-  }
+    result = std::span<uint8_t>(static_cast<uint8_t *>(data), len);
 
-  jsi::Value
-  callAsConstructor(const jsi::Function &constructor, const jsi::Value *args, size_t count) override {
-    int err;
+    return true;
+  }
 
-    std::vector<js_value_t *> argv;
+  bool
+  toNative(js_value_t *value, jsi::Value &result) {
+    result = as(value);
 
-    argv.reserve(count);
+    return true;
+  }
 
-    for (size_t i = 0; i < count; i++) {
-      argv.push_back(as(args[i]));
-    }
+  js_value_t *
+  fromNative(bool value) {
+    int err;
 
     js_value_t *result;
-    err = js_new_instance(env, as(constructor), count, argv.data(), &result);
-    if (err < 0) throw lastException();
+    err = js_get_boolean(env, value, &result);
+    assert(err == 0);
 
-    return as(result);
+    return result;
   }
 
-  ScopeState *
-  pushScope() override {
+  js_value_t *
+  fromNative(double value) {
     int err;
 
-    js_handle_scope_t *scope;
-    err = js_open_handle_scope(env, &scope);
-    if (err < 0) throw lastException();
+    js_value_t *result;
+    err = js_create_double(env, value, &result);
+    assert(err == 0);
 
-    return reinterpret_cast<ScopeState *>(scope);
+    return result;
   }
 
-  void
-  popScope(ScopeState *state) override {
+  js_value_t *
+  fromNative(int32_t value) {
     int err;
 
-    auto scope = reinterpret_cast<js_handle_scope_t *>(state);
-    err = js_close_handle_scope(env, scope);
+    js_value_t *result;
+    err = js_create_int32(env, value, &result);
     assert(err == 0);
 
-    return;
-  }
-
-  bool
-  strictEquals(const jsi::Symbol &a, const jsi::Symbol &b) const override {
-    return strictEquals(static_cast<const jsi::Pointer &>(a), b);
+    return result;
   }
 
-  bool
-  strictEquals(const jsi::BigInt &a, const jsi::BigInt &b) const override {
-    return strictEquals(static_cast<const jsi::Pointer &>(a), b);
-  }
+  js_value_t *
+  fromNative(uint32_t value) {
+    int err;
 
-  bool
-  strictEquals(const jsi::String &a, const jsi::String &b) const override {
-    return strictEquals(static_cast<const jsi::Pointer &>(a), b);
-  }
+    js_value_t *result;
+    err = js_create_uint32(env, value, &result);
+    assert(err == 0);
 
-  bool
-  strictEquals(const jsi::Object &a, const jsi::Object &b) const override {
-    return strictEquals(static_cast<const jsi::Pointer &>(a), b);
+    return result;
   }
 
-  inline bool
-  strictEquals(const jsi::Pointer &a, const jsi::Pointer &b) const {
+  js_value_t *
+  fromNative(int64_t value) {
     int err;
 
-    bool result;
-    err = js_strict_equals(env, as(a), as(b), &result);
+    js_value_t *result;
+    err = js_create_int64(env, value, &result);
     assert(err == 0);
 
     return result;
   }
 
-  bool
-  instanceOf(const jsi::Object &object, const jsi::Function &constructor) override {
+  js_value_t *
+  fromNative(const char *value) {
+    return fromNative(std::string_view(value));
+  }
+
+  js_value_t *
+  fromNative(std::string_view value) {
     int err;
 
-    bool result;
-    err = js_instanceof(env, as(object), as(constructor), &result);
+    js_value_t *result;
+    err = js_create_string_utf8(env, reinterpret_cast<const utf8_t *>(value.data()), value.length(), &result);
     if (err < 0) throw lastException();
 
     return result;
   }
 
-  void
-  setExternalMemoryPressure(const jsi::Object &obj, size_t amount) override {}
+  js_value_t *
+  fromNative(const jsi::Value &value) {
+    return as(value);
+  }
 
-private:
-  std::deque<jsi::Function> microtask_queue;
+  struct JSIPreparedJavaScript : jsi::PreparedJavaScript {
+    std::shared_ptr<const jsi::Buffer> buffer;
+    std::string file;
 
-  template <typename T>
-  static void
-  finalize(js_env_t *, void *data, void *finalize_hint) {
-    delete static_cast<T *>(finalize_hint);
-  }
+    JSIPreparedJavaScript(std::shared_ptr<const jsi::Buffer> buffer, std::string file)
+        : buffer(buffer),
+          file(file) {}
 
-  template <typename T>
-  inline T
-  make(js_value_t *value) const {
-    return Runtime::make<T>(new JSIPointerValue(env, value));
-  }
+    JSIPreparedJavaScript(const JSIPreparedJavaScript &) = delete;
 
-  template <>
-  inline jsi::WeakObject
-  make(js_value_t *value) const {
-    return Runtime::make<jsi::WeakObject>(new JSIWeakPointerValue(env, value));
-  }
+    JSIPreparedJavaScript &
+    operator=(const JSIPreparedJavaScript &) = delete;
+  };
 
   template <typename T>
-  inline const T *
-  as(const jsi::Pointer &p) const {
-    return as<T>(getPointerValue(p));
-  }
+  struct JSIPool {
+    static constexpr size_t slab_size = 16384;
 
-  template <typename T>
-  inline const T *
-  as(const PointerValue *pv) const {
-    return static_cast<const T *>(pv);
-  }
+    union JSISlot {
+      JSISlot *next;
+      alignas(T) unsigned char data[sizeof(T)];
+    };
 
-  inline js_value_t *
-  as(const jsi::Pointer &p) const {
-    return as(getPointerValue(p));
-  }
+    struct JSISlab {
+      JSIPool *pool;
+      JSISlab *next;
+    };
 
-  inline js_value_t *
-  as(const PointerValue *pv) const {
-    return as<JSIPointerValue>(pv)->value();
-  }
+    static constexpr size_t slab_offset = (sizeof(JSISlab) + alignof(JSISlot) - 1) / alignof(JSISlot) * alignof(JSISlot);
 
-  inline js_value_t *
-  as(const jsi::Value &v) const {
-    int err;
+    static constexpr size_t slab_capacity = (slab_size - slab_offset) / sizeof(JSISlot);
 
-    js_value_t *value;
+    JSIRuntime &runtime;
+    JSISlab *slabs;
+    JSISlot *free;
+    JSISlot *next;
+    JSISlot *end;
+    JSIPoolStats stats;
 
-    if (v.isUndefined()) {
-      err = js_get_undefined(env, &value);
-      assert(err == 0);
+    JSIPool(JSIRuntime &runtime)
+        : runtime(runtime),
+          slabs(nullptr),
+          free(nullptr),
+          next(nullptr),
+          end(nullptr),
+          stats() {}
 
-      return value;
+    JSIPool(const JSIPool &) = delete;
+
+    ~JSIPool() {
+      while (slabs) {
+        auto slab = slabs;
+
+        slabs = slab->next;
+
+        ::operator delete(slab, std::align_val_t(slab_size));
+      }
     }
 
-    if (v.isNull()) {
-      err = js_get_null(env, &value);
-      assert(err == 0);
+    JSIPool &
+    operator=(const JSIPool &) = delete;
 
-      return value;
+    template <typename... Args>
+    inline T *
+    alloc(Args &&...args) {
+      JSISlot *slot;
+
+      if (free) {
+        slot = free;
+        free = slot->next;
+
+        stats.hits++;
+      } else {
+        if (next == end) grow();
+
+        slot = next++;
+
+        stats.misses++;
+      }
+
+      stats.live++;
+
+      return new (slot->data) T(std::forward<Args>(args)...);
     }
 
-    if (v.isBool()) {
-      err = js_get_boolean(env, v.getBool(), &value);
-      assert(err == 0);
+    inline void
+    release(T *value) {
+      value->~T();
 
-      return value;
+      auto slot = reinterpret_cast<JSISlot *>(value);
+
+      slot->next = free;
+      free = slot;
+
+      stats.live--;
     }
 
-    if (v.isNumber()) {
-      err = js_create_double(env, v.getNumber(), &value);
-      assert(err == 0);
+    static inline JSIPool &
+    from(const T *value) {
+      auto slab = reinterpret_cast<JSISlab *>(reinterpret_cast<uintptr_t>(value) & ~(slab_size - 1));
 
-      return value;
+      return *slab->pool;
     }
 
-    js_escapable_handle_scope_t *scope;
-    err = js_open_escapable_handle_scope(env, &scope);
-    assert(err == 0);
+  private:
+    void
+    grow() {
+      auto slab = static_cast<JSISlab *>(::operator new(slab_size, std::align_val_t(slab_size)));
 
-    err = js_escape_handle(env, scope, as(getPointerValue(v)), &value);
-    assert(err == 0);
+      slab->pool = this;
+      slab->next = slabs;
 
-    err = js_close_escapable_handle_scope(env, scope);
-    assert(err == 0);
+      slabs = slab;
 
-    return value;
-  }
+      next = reinterpret_cast<JSISlot *>(reinterpret_cast<char *>(slab) + slab_offset);
+      end = next + slab_capacity;
 
-  inline js_value_t *
-  as(const jsi::JSError &err) {
-    return as(err.value());
-  }
+      stats.slabs++;
+    }
+  };
 
-  jsi::Value
-  as(js_value_t *v) const {
-    int err;
+  // A handle scope opened either through `jsi::Scope` or on entry to a
+  // callback from JavaScript. Pointer values created while the scope is open
+  // hold the raw handle and are linked into `locals`; any that are still alive
+  // when the scope is closed are promoted to references. Handles for the
+  // primitive singletons are fetched at most once per scope. Every scope has
+  // an identifier that is unique for the lifetime of the runtime, which lets
+  // handles cached outside of it be checked for validity.
+  struct JSIScope {
+    js_handle_scope_t *scope;
+    uint64_t id;
+    JSIPointerValue *locals;
+    js_value_t *primitives[4];
 
-    js_value_type_t type;
-    err = js_typeof(env, v, &type);
-    assert(err == 0);
+    JSIScope(js_handle_scope_t *scope, uint64_t id)
+        : scope(scope),
+          id(id),
+          locals(nullptr),
+          primitives() {}
 
-    switch (type) {
-    case js_undefined:
-      return jsi::Value::undefined();
+    JSIScope(const JSIScope &) = delete;
 
-    case js_null:
-    default:
-      return jsi::Value::null();
+    JSIScope &
+    operator=(const JSIScope &) = delete;
 
-    case js_boolean: {
-      bool value;
-      err = js_get_value_bool(env, v, &value);
-      assert(err == 0);
+    inline void
+    promote() {
+      while (locals) locals->promote();
+    }
+  };
 
-      return jsi::Value(value);
+  struct JSICallbackScope {
+    JSIRuntime &runtime;
+
+    JSICallbackScope(JSIRuntime &runtime)
+        : runtime(runtime) {
+      runtime.scopes.emplace_back(nullptr, ++runtime.scope_ids);
     }
 
-    case js_number: {
-      double value;
-      err = js_get_value_double(env, v, &value);
-      assert(err == 0);
+    JSICallbackScope(const JSICallbackScope &) = delete;
 
-      return jsi::Value(value);
+    ~JSICallbackScope() {
+      runtime.scopes.back().promote();
+      runtime.scopes.pop_back();
     }
 
-    case js_string:
-      return make<jsi::String>(v);
+    JSICallbackScope &
+    operator=(const JSICallbackScope &) = delete;
+  };
 
-    case js_symbol:
-      return make<jsi::Symbol>(v);
+  // The receiver, data and arguments of a callback, fetched in a single pass
+  // into a stack buffer of `capacity` handles. Calls with more arguments than
+  // that fetch them again into a heap buffer sized for the call.
+  template <size_t capacity>
+  struct JSICallbackArguments {
+    std::array<js_value_t *, capacity> inline_argv;
+    std::vector<js_value_t *> overflow_argv;
+    js_value_t **argv;
+    size_t argc;
+    js_value_t *receiver;
+    void *data;
+
+    JSICallbackArguments(js_env_t *env, js_callback_info_t *info)
+        : argv(inline_argv.data()),
+          argc(capacity) {
+      int err;
 
-    case js_object:
-    case js_external:
-      return make<jsi::Object>(v);
+      err = js_get_callback_info(env, info, &argc, inline_argv.data(), &receiver, &data);
+      assert(err == 0);
 
-    case js_function:
-      return make<jsi::Function>(v);
+      if (argc > capacity) {
+        overflow_argv.resize(argc);
 
-    case js_bigint:
-      return make<jsi::BigInt>(v);
+        err = js_get_callback_info(env, info, &argc, overflow_argv.data(), nullptr, nullptr);
+        assert(err == 0);
+
+        argv = overflow_argv.data();
+      }
     }
-  }
 
-  inline jsi::JSError
-  lastException() {
-    int err;
+    JSICallbackArguments(const JSICallbackArguments &) = delete;
 
-    js_value_t *error;
-    err = js_get_and_clear_last_exception(env, &error);
-    assert(err == 0);
+    JSICallbackArguments &
+    operator=(const JSICallbackArguments &) = delete;
+  };
 
-    return jsi::JSError(*this, as(error));
+  // Select a trampoline of the reference type T whose stack buffers fit the
+  // declared parameter count, falling back to heap buffers sized on each
+  // call for very wide functions.
+  template <typename T>
+  static js_function_cb
+  trampoline(unsigned int argc) {
+    if (argc <= 4) return T::template call<4>;
+    if (argc <= 8) return T::template call<8>;
+    if (argc <= 16) return T::template call<16>;
+    return T::template call<0>;
   }
 
-  struct JSIPreparedJavaScript : jsi::PreparedJavaScript {
-    std::shared_ptr<const jsi::Buffer> buffer;
-    std::string file;
+  struct JSIArgumentBuffer {
+    static const size_t inline_capacity = 8;
 
-    JSIPreparedJavaScript(std::shared_ptr<const jsi::Buffer> buffer, std::string file)
-        : buffer(buffer),
-          file(file) {}
+    JSIRuntime &runtime;
+    js_value_t **argv;
+    js_value_t *inline_argv[inline_capacity];
+    std::vector<js_value_t *> scratch;
 
-    JSIPreparedJavaScript(const JSIPreparedJavaScript &) = delete;
+    JSIArgumentBuffer(JSIRuntime &runtime, const jsi::Value *args, size_t count)
+        : runtime(runtime),
+          argv(inline_argv) {
+      if (count > inline_capacity) {
+        // Borrow the runtime scratch buffer for the duration of the call. A
+        // reentrant call made while it's borrowed simply allocates its own.
+        scratch = std::move(runtime.scratch_argv);
+        scratch.resize(count);
+
+        argv = scratch.data();
+      }
 
-    JSIPreparedJavaScript &
-    operator=(const JSIPreparedJavaScript &) = delete;
+      for (size_t i = 0; i < count; i++) {
+        argv[i] = runtime.as(args[i]);
+      }
+    }
+
+    JSIArgumentBuffer(const JSIArgumentBuffer &) = delete;
+
+    ~JSIArgumentBuffer() {
+      if (scratch.capacity() > runtime.scratch_argv.capacity()) {
+        runtime.scratch_argv = std::move(scratch);
+      }
+    }
+
+    JSIArgumentBuffer &
+    operator=(const JSIArgumentBuffer &) = delete;
   };
 
+  // Pointer values are allocated from a per-runtime pool and find their way
+  // back to it, and from there to the environment, through the slab header.
+  // Values in local mode are linked into their scope, which is also what
+  // distinguishes them from values holding a reference. Clones share the same
+  // pointer value, so the reference is only created once and deleted when the
+  // last owner lets go of it.
   struct JSIPointerValue : PointerValue {
-    js_env_t *env;
-    js_ref_t *ref;
+    union {
+      js_ref_t *ref;
+      js_value_t *local;
+    };
 
-    JSIPointerValue(js_env_t *env, js_value_t *value)
-        : env(env) {
-      int err;
+    JSIPointerValue *next;
+    JSIPointerValue **prev;
 
-      err = js_create_reference(env, value, 1, &ref);
-      assert(err == 0);
-    }
+    uint32_t refs;
+
+    mutable uint8_t resolved;
+    mutable uint8_t kinds;
+    mutable uint32_t atom;
 
-    JSIPointerValue(js_env_t *env, js_ref_t *ref)
-        : env(env),
-          ref(ref) {
+    JSIPointerValue(js_value_t *value)
+        : next(nullptr),
+          prev(nullptr),
+          refs(1),
+          resolved(0),
+          kinds(0),
+          atom(0) {
       int err;
 
-      err = js_reference_ref(env, ref, nullptr);
+      err = js_create_reference(env(), value, 1, &ref);
       assert(err == 0);
     }
 
+    JSIPointerValue(JSIScope &scope, js_value_t *value)
+        : local(value),
+          refs(1),
+          resolved(0),
+          kinds(0),
+          atom(0) {
+      link(&scope.locals);
+    }
+
     JSIPointerValue(const JSIPointerValue &) = delete;
 
     ~JSIPointerValue() override {
-      int err;
-
-      uint32_t refs;
-      err = js_reference_unref(env, ref, &refs);
-      assert(err == 0);
-
-      if (refs == 0) {
-        err = js_delete_reference(env, ref);
-        assert(err == 0);
-      }
+      if (isLocal()) unlink();
+      else runtime().release(ref);
     }
 
     JSIPointerValue &
     operator=(const JSIPointerValue &) = delete;
 
+    static inline JSIPointerValue *
+    clone(const JSIPointerValue *pv) {
+      auto value = const_cast<JSIPointerValue *>(pv);
+
+      value->refs++;
+
+      return value;
+    }
+
+    inline JSIRuntime &
+    runtime() const {
+      return JSIPool<JSIPointerValue>::from(this).runtime;
+    }
+
+    inline js_env_t *
+    env() const {
+      return runtime().env;
+    }
+
+    inline bool
+    isLocal() const {
+      return prev != nullptr;
+    }
+
     inline js_value_t *
     value() const {
       int err;
 
+      if (isLocal()) return local;
+
       js_value_t *value;
-      err = js_get_reference_value(env, ref, &value);
+      err = js_get_reference_value(env(), ref, &value);
       assert(err == 0);
 
       return value;
     }
 
+    // The object kinds are mutually exclusive, except for host functions
+    // being functions, so a single positive answer settles the others.
+    inline void
+    learn(uint8_t kind, bool result) const {
+      if (result) {
+        kinds |= kind;
+
+        if (kind == JSIHostFunctionKind) kinds |= JSIFunctionKind;
+
+        resolved |= kind == JSIFunctionKind ? JSIAllKinds & ~JSIHostFunctionKind : JSIAllKinds;
+      } else {
+        resolved |= kind;
+
+        if (kind == JSIFunctionKind) resolved |= JSIHostFunctionKind;
+      }
+    }
+
+    inline void
+    promote() {
+      int err;
+
+      auto value = local;
+
+      unlink();
+
+      err = js_create_reference(env(), value, 1, &ref);
+      assert(err == 0);
+    }
+
+    inline void
+    link(JSIPointerValue *const *head) {
+      auto slot = const_cast<JSIPointerValue **>(head);
+
+      next = *slot;
+      prev = slot;
+
+      if (next) next->prev = &next;
+
+      *slot = this;
+    }
+
+    inline void
+    unlink() {
+      *prev = next;
+
+      if (next) next->prev = prev;
+
+      next = nullptr;
+      prev = nullptr;
+    }
+
     inline std::string
     toString(JSIRuntime &runtime) const {
       int err;
 
+      auto env = runtime.env;
+
       auto value = this->value();
 
       err = js_coerce_to_string(env, value, &value);
@@ -1087,46 +2981,55 @@ private:
       err = js_get_value_string_utf8(env, value, reinterpret_cast<utf8_t *>(str.data()), len, nullptr);
       assert(err == 0);
 
-      return std::move(str);
+      return str;
     }
 
   protected:
     void
     invalidate() noexcept override {
-      delete this;
+      auto &pool = JSIPool<JSIPointerValue>::from(this);
+
+      if (!pool.runtime.isCurrentThread()) return pool.runtime.defer(this);
+
+      if (--refs == 0) pool.release(this);
     }
   };
 
   struct JSIWeakPointerValue : PointerValue {
-    js_env_t *env;
     js_ref_t *ref;
 
-    JSIWeakPointerValue(js_env_t *env, js_value_t *value)
-        : env(env) {
+    JSIWeakPointerValue(js_value_t *value) {
       int err;
 
-      err = js_create_reference(env, value, 0, &ref);
+      err = js_create_reference(env(), value, 0, &ref);
       assert(err == 0);
     }
 
     JSIWeakPointerValue(const JSIWeakPointerValue &) = delete;
 
     ~JSIWeakPointerValue() override {
-      int err;
-
-      err = js_delete_reference(env, ref);
-      assert(err == 0);
+      runtime().release(ref);
     }
 
     JSIWeakPointerValue &
     operator=(const JSIWeakPointerValue &) = delete;
 
+    inline JSIRuntime &
+    runtime() const {
+      return JSIPool<JSIWeakPointerValue>::from(this).runtime;
+    }
+
+    inline js_env_t *
+    env() const {
+      return runtime().env;
+    }
+
     inline js_value_t *
     value() const {
       int err;
 
       js_value_t *value;
-      err = js_get_reference_value(env, ref, &value);
+      err = js_get_reference_value(env(), ref, &value);
       assert(err == 0);
 
       return value;
@@ -1135,10 +3038,31 @@ private:
   protected:
     void
     invalidate() noexcept override {
-      delete this;
+      auto &pool = JSIPool<JSIWeakPointerValue>::from(this);
+
+      if (!pool.runtime.isCurrentThread()) return pool.runtime.defer(this);
+
+      pool.release(this);
     }
   };
 
+  JSIPool<JSIPointerValue> pointer_values;
+  JSIPool<JSIWeakPointerValue> weak_pointer_values;
+
+  struct JSIDeferredRelease {
+    PointerValue *value;
+    JSIDeferredRelease *next;
+
+    JSIDeferredRelease(PointerValue *value, JSIDeferredRelease *next)
+        : value(value),
+          next(next) {}
+
+    JSIDeferredRelease(const JSIDeferredRelease &) = delete;
+
+    JSIDeferredRelease &
+    operator=(const JSIDeferredRelease &) = delete;
+  };
+
   struct JSIArrayBufferReference {
     std::shared_ptr<jsi::MutableBuffer> buffer;
 
@@ -1155,9 +3079,11 @@ private:
     static constexpr js_type_tag_t tag = {0x5a84bf0d0e22401b, 0x858564a9aca352c2};
 
     std::shared_ptr<jsi::NativeState> state;
+    const JSIHostClassReference *owner;
 
-    JSINativeStateReference(std::shared_ptr<jsi::NativeState> &&state)
-        : state(std::move(state)) {}
+    JSINativeStateReference(std::shared_ptr<jsi::NativeState> &&state, const JSIHostClassReference *owner = nullptr)
+        : state(std::move(state)),
+          owner(owner) {}
 
     JSINativeStateReference(const JSINativeStateReference &) = delete;
 
@@ -1170,26 +3096,59 @@ private:
 
     JSIRuntime &runtime;
     std::shared_ptr<jsi::HostObject> object;
+    JSIHostObject *hooks;
+    js_ref_t *keys;
+    bool cache_keys;
+    bool atoms;
 
     JSIHostObjectReference(JSIRuntime &runtime, std::shared_ptr<jsi::HostObject> &&object)
         : runtime(runtime),
-          object(std::move(object)) {}
+          object(std::move(object)),
+          hooks(dynamic_cast<JSIHostObject *>(this->object.get())),
+          keys(nullptr),
+          cache_keys(false),
+          atoms(hooks && hooks->atoms) {}
 
     JSIHostObjectReference(const JSIHostObjectReference &) = delete;
 
+    // Destroyed from the finalizer of the host object, where the cached keys
+    // are deleted directly rather than queued.
+    ~JSIHostObjectReference() {
+      int err;
+
+      if (keys == nullptr) return;
+
+      err = js_delete_reference(runtime.env, keys);
+      assert(err == 0);
+    }
+
     JSIHostObjectReference &
     operator=(const JSIHostObjectReference &) = delete;
 
+    inline void
+    invalidate() {
+      if (keys == nullptr) return;
+
+      runtime.release(keys);
+
+      keys = nullptr;
+    }
+
     static js_value_t *
     get(js_env_t *env, js_value_t *property, void *data) {
       int err;
 
       auto ref = static_cast<JSIHostObjectReference *>(data);
 
+      JSICallbackScope scope(ref->runtime);
+
       jsi::Value value;
 
       try {
-        value = ref->object->get(ref->runtime, ref->runtime.make<jsi::PropNameID>(property));
+        auto name = ref->atoms ? ref->runtime.interned(property) : nullptr;
+
+        if (name) value = ref->object->get(ref->runtime, *name);
+        else value = ref->object->get(ref->runtime, ref->runtime.make<jsi::PropNameID>(property));
       } catch (const jsi::JSError &error) {
         err = js_throw(env, ref->runtime.as(error));
         assert(err == 0);
@@ -1211,8 +3170,13 @@ private:
 
       auto ref = static_cast<JSIHostObjectReference *>(data);
 
+      JSICallbackScope scope(ref->runtime);
+
       try {
-        ref->object->set(ref->runtime, ref->runtime.make<jsi::PropNameID>(property), ref->runtime.as(value));
+        auto name = ref->atoms ? ref->runtime.interned(property) : nullptr;
+
+        if (name) ref->object->set(ref->runtime, *name, ref->runtime.as(value));
+        else ref->object->set(ref->runtime, ref->runtime.make<jsi::PropNameID>(property), ref->runtime.as(value));
       } catch (const jsi::JSError &error) {
         err = js_throw(env, ref->runtime.as(error));
         assert(err == 0);
@@ -1228,12 +3192,77 @@ private:
       return true;
     }
 
+    static bool
+    has(js_env_t *env, js_value_t *property, void *data) {
+      int err;
+
+      auto ref = static_cast<JSIHostObjectReference *>(data);
+
+      JSICallbackScope scope(ref->runtime);
+
+      try {
+        auto name = ref->atoms ? ref->runtime.interned(property) : nullptr;
+
+        if (name) return ref->hooks->has(ref->runtime, *name);
+
+        return ref->hooks->has(ref->runtime, ref->runtime.make<jsi::PropNameID>(property));
+      } catch (const jsi::JSError &error) {
+        err = js_throw(env, ref->runtime.as(error));
+        assert(err == 0);
+
+        return false;
+      } catch (const std::exception &error) {
+        err = js_throw_error(env, NULL, error.what());
+        assert(err == 0);
+
+        return false;
+      }
+    }
+
+    static bool
+    deleteProperty(js_env_t *env, js_value_t *property, void *data) {
+      int err;
+
+      auto ref = static_cast<JSIHostObjectReference *>(data);
+
+      JSICallbackScope scope(ref->runtime);
+
+      try {
+        auto name = ref->atoms ? ref->runtime.interned(property) : nullptr;
+
+        if (name) return ref->hooks->deleteProperty(ref->runtime, *name);
+
+        return ref->hooks->deleteProperty(ref->runtime, ref->runtime.make<jsi::PropNameID>(property));
+      } catch (const jsi::JSError &error) {
+        err = js_throw(env, ref->runtime.as(error));
+        assert(err == 0);
+
+        return false;
+      } catch (const std::exception &error) {
+        err = js_throw_error(env, NULL, error.what());
+        assert(err == 0);
+
+        return false;
+      }
+    }
+
     static js_value_t *
     ownKeys(js_env_t *env, void *data) {
       int err;
 
       auto ref = static_cast<JSIHostObjectReference *>(data);
 
+      js_value_t *result;
+
+      if (ref->keys) {
+        err = js_get_reference_value(env, ref->keys, &result);
+        assert(err == 0);
+
+        return result;
+      }
+
+      JSICallbackScope scope(ref->runtime);
+
       std::vector<jsi::PropNameID> keys;
 
       try {
@@ -1250,12 +3279,22 @@ private:
         return nullptr;
       }
 
-      js_value_t *result;
-      err = js_create_array_with_length(env, keys.size(), &result);
+      std::vector<const js_value_t *> elements;
+
+      elements.reserve(keys.size());
+
+      for (auto &key : keys) {
+        elements.push_back(ref->runtime.as(key));
+      }
+
+      err = js_create_array_with_length(env, elements.size(), &result);
+      assert(err == 0);
+
+      err = js_set_array_elements(env, result, elements.data(), elements.size(), 0);
       assert(err == 0);
 
-      for (size_t i = 0, n = keys.size(); i < n; i++) {
-        err = js_set_element(env, result, i, ref->runtime.as(keys[i]));
+      if (ref->cache_keys) {
+        err = js_create_reference(env, result, 1, &ref->keys);
         assert(err == 0);
       }
 
@@ -1263,51 +3302,248 @@ private:
     }
   };
 
-  struct JSIHostFunctionReference {
+  // Holds the callable of a host function inline, so that it's invoked
+  // without the indirection of a type-erased wrapper unless it is one. Only
+  // functions created through createFunctionFromHostFunction() are tagged.
+  template <typename F>
+  struct JSICallableReference {
     static constexpr js_type_tag_t tag = {0xfab8af594a3d4e86, 0xbedeafddfc1ef064};
 
     JSIRuntime &runtime;
-    jsi::HostFunctionType function;
+    F function;
 
-    JSIHostFunctionReference(JSIRuntime &runtime, jsi::HostFunctionType function)
+    JSICallableReference(JSIRuntime &runtime, F function)
         : runtime(runtime),
-          function(function) {}
+          function(std::move(function)) {}
 
-    JSIHostFunctionReference(const JSIHostFunctionReference &) = delete;
+    JSICallableReference(const JSICallableReference &) = delete;
 
-    JSIHostFunctionReference &
-    operator=(const JSIHostFunctionReference &) = delete;
+    JSICallableReference &
+    operator=(const JSICallableReference &) = delete;
 
+    template <size_t capacity>
     static js_value_t *
     call(js_env_t *env, js_callback_info_t *info) {
+      JSICallbackArguments<capacity> arguments(env, info);
+
+      auto ref = static_cast<JSICallableReference *>(arguments.data);
+
+      return invoke(env, ref->runtime, ref->function, arguments);
+    }
+
+    template <size_t capacity>
+    static js_value_t *
+    invoke(js_env_t *env, JSIRuntime &runtime, F &function, const JSICallbackArguments<capacity> &arguments) {
       int err;
 
-      JSIHostFunctionReference *ref;
+      auto argc = arguments.argc;
+      auto argv = arguments.argv;
+      auto receiver = arguments.receiver;
+
+      JSICallbackScope scope(runtime);
+
+      std::array<jsi::Value, capacity> inline_args;
+
+      jsi::Value *args = inline_args.data();
+
+      std::vector<jsi::Value> overflow_args;
+
+      if (argc > capacity) {
+        overflow_args.resize(argc);
+
+        args = overflow_args.data();
+      }
+
+      for (size_t i = 0; i < argc; i++) {
+        args[i] = runtime.as(argv[i]);
+      }
+
+      jsi::Value value;
+
+      try {
+        value = function(runtime, runtime.as(receiver), args, argc);
+      } catch (const jsi::JSError &error) {
+        err = js_throw(env, runtime.as(error));
+        assert(err == 0);
+
+        return nullptr;
+      } catch (const std::exception &error) {
+        err = js_throw_error(env, NULL, error.what());
+        assert(err == 0);
+
+        return nullptr;
+      }
+
+      return runtime.as(value);
+    }
+  };
+
+  using JSIHostFunctionReference = JSICallableReference<jsi::HostFunctionType>;
+
+  // Members of a host class only make sense on instances of that class
+  // created through createHostInstance(), so any other receiver, such as one
+  // constructed by `new` from JS or an instance of another host class, is
+  // rejected before the member is called.
+  struct JSIHostMemberReference {
+    JSIRuntime &runtime;
+    const JSIHostClassReference *owner;
+    jsi::HostFunctionType function;
+
+    JSIHostMemberReference(JSIRuntime &runtime, const JSIHostClassReference *owner, jsi::HostFunctionType function)
+        : runtime(runtime),
+          owner(owner),
+          function(std::move(function)) {}
+
+    JSIHostMemberReference(const JSIHostMemberReference &) = delete;
+
+    JSIHostMemberReference &
+    operator=(const JSIHostMemberReference &) = delete;
+
+    template <size_t capacity>
+    static js_value_t *
+    call(js_env_t *env, js_callback_info_t *info) {
+      JSICallbackArguments<capacity> arguments(env, info);
+
+      return invoke(env, static_cast<JSIHostMemberReference *>(arguments.data), arguments);
+    }
+
+    template <size_t capacity>
+    static js_value_t *
+    invoke(js_env_t *env, JSIHostMemberReference *ref, const JSICallbackArguments<capacity> &arguments) {
+      int err;
 
-      size_t argc;
-      err = js_get_callback_info(env, info, &argc, nullptr, nullptr, nullptr);
+      js_value_type_t type;
+      err = js_typeof(env, arguments.receiver, &type);
       assert(err == 0);
 
-      std::vector<js_value_t *> argv;
+      bool valid = false;
+
+      if (type == js_object) {
+        err = js_check_type_tag(env, arguments.receiver, &JSINativeStateReference::tag, &valid);
+        assert(err == 0);
+      }
+
+      if (valid) {
+        JSINativeStateReference *state;
+        err = js_unwrap(env, arguments.receiver, reinterpret_cast<void **>(&state));
+        assert(err == 0);
+
+        valid = state->owner == ref->owner;
+      }
+
+      if (!valid) {
+        err = js_throw_type_error(env, NULL, "Illegal invocation");
+        assert(err == 0);
+
+        return nullptr;
+      }
+
+      return JSIHostFunctionReference::invoke(env, ref->runtime, ref->function, arguments);
+    }
+  };
+
+  // Both sides of an accessor share the single data pointer of its property
+  // descriptor, so each side is reached through its own callback.
+  struct JSIHostAccessorReference {
+    std::unique_ptr<JSIHostMemberReference> getter;
+    std::unique_ptr<JSIHostMemberReference> setter;
+
+    JSIHostAccessorReference() = default;
+
+    JSIHostAccessorReference(const JSIHostAccessorReference &) = delete;
+
+    JSIHostAccessorReference &
+    operator=(const JSIHostAccessorReference &) = delete;
+
+    static js_value_t *
+    get(js_env_t *env, js_callback_info_t *info) {
+      JSICallbackArguments<4> arguments(env, info);
+
+      auto ref = static_cast<JSIHostAccessorReference *>(arguments.data);
+
+      return JSIHostMemberReference::invoke(env, ref->getter.get(), arguments);
+    }
+
+    static js_value_t *
+    set(js_env_t *env, js_callback_info_t *info) {
+      JSICallbackArguments<4> arguments(env, info);
+
+      auto ref = static_cast<JSIHostAccessorReference *>(arguments.data);
+
+      return JSIHostMemberReference::invoke(env, ref->setter.get(), arguments);
+    }
+  };
+
+  // Owns the members of a host class. Its methods and accessors are separate
+  // functions that may outlive the constructor, so the runtime keeps this
+  // until it's destroyed rather than tying it to the constructor.
+  struct JSIHostClassReference {
+    static constexpr js_type_tag_t tag = {0x3e6f1b2d8c4a4f57, 0x9d21c7e05b836a14};
+
+    std::vector<std::unique_ptr<JSIHostMemberReference>> methods;
+    std::vector<std::unique_ptr<JSIHostAccessorReference>> accessors;
 
-      argv.reserve(argc);
+    JSIHostClassReference() = default;
+
+    JSIHostClassReference(const JSIHostClassReference &) = delete;
+
+    JSIHostClassReference &
+    operator=(const JSIHostClassReference &) = delete;
+
+    static js_value_t *
+    construct(js_env_t *env, js_callback_info_t *info) {
+      int err;
 
       js_value_t *receiver;
-      err = js_get_callback_info(env, info, &argc, argv.data(), &receiver, reinterpret_cast<void **>(&ref));
+      err = js_get_callback_info(env, info, nullptr, nullptr, &receiver, nullptr);
       assert(err == 0);
 
-      std::vector<jsi::Value> args;
+      return receiver;
+    }
+  };
 
-      args.reserve(argc);
+  struct JSIHostFunctionPointerCall {
+    JSIHostFunctionPointer function;
+    void *data;
 
-      for (size_t i = 0; i < argc; i++) {
-        args.push_back(ref->runtime.as(argv[i]));
-      }
+    jsi::Value
+    operator()(jsi::Runtime &runtime, const jsi::Value &receiver, const jsi::Value *args, size_t count) const {
+      return function(runtime, receiver, args, count, data);
+    }
+  };
+
+  struct JSIArgumentsFunctionReference {
+    JSIRuntime &runtime;
+    JSIArgumentsFunctionType function;
+
+    JSIArgumentsFunctionReference(JSIRuntime &runtime, JSIArgumentsFunctionType function)
+        : runtime(runtime),
+          function(std::move(function)) {}
+
+    JSIArgumentsFunctionReference(const JSIArgumentsFunctionReference &) = delete;
+
+    JSIArgumentsFunctionReference &
+    operator=(const JSIArgumentsFunctionReference &) = delete;
+
+    template <size_t capacity>
+    static js_value_t *
+    call(js_env_t *env, js_callback_info_t *info) {
+      int err;
+
+      JSICallbackArguments<capacity> arguments(env, info);
+
+      auto ref = static_cast<JSIArgumentsFunctionReference *>(arguments.data);
+
+      auto argc = arguments.argc;
+      auto argv = arguments.argv;
+      auto receiver = arguments.receiver;
+
+      JSICallbackScope scope(ref->runtime);
 
       jsi::Value value;
 
       try {
-        value = ref->function(ref->runtime, ref->runtime.as(receiver), args.data(), argc);
+        value = ref->function(ref->runtime, JSIArguments{ref->runtime, receiver, argv, argc});
       } catch (const jsi::JSError &error) {
         err = js_throw(env, ref->runtime.as(error));
         assert(err == 0);
@@ -1323,4 +3559,139 @@ private:
       return ref->runtime.as(value);
     }
   };
+
+  // Arguments are converted into storage of these types before the call;
+  // string views borrow from a std::string owned by the trampoline.
+  template <typename T>
+  using JSITypedStorage = std::conditional_t<std::is_same_v<std::decay_t<T>, std::string_view>, std::string, std::decay_t<T>>;
+
+  // The engine type of a value passed on the fast call path, or -1 if the
+  // type can't be passed without going through a handle.
+  template <typename T>
+  static constexpr int
+  fastType() {
+    if constexpr (std::is_void_v<T>) return js_undefined;
+    else if constexpr (std::is_same_v<T, bool>) return js_boolean;
+    else if constexpr (std::is_same_v<T, int32_t>) return js_int32;
+    else if constexpr (std::is_same_v<T, uint32_t>) return js_uint32;
+    else if constexpr (std::is_same_v<T, double>) return js_float64;
+    else return -1;
+  }
+
+  template <typename F, typename R, typename... Args>
+  struct JSITypedFunctionReference {
+    static constexpr bool fast = std::is_nothrow_invocable_v<F &, std::decay_t<Args>...> && fastType<R>() != -1 && ((fastType<std::decay_t<Args>>() != -1) && ...);
+
+    static inline int signature_args[] = {js_object, fastType<std::decay_t<Args>>()...};
+
+    static inline js_callback_signature_t signature = {
+      .version = 0,
+      .result = fastType<R>(),
+      .args_len = sizeof...(Args) + 1,
+      .args = signature_args,
+    };
+
+    JSIRuntime &runtime;
+    F function;
+
+    JSITypedFunctionReference(JSIRuntime &runtime, F function)
+        : runtime(runtime),
+          function(std::move(function)) {}
+
+    JSITypedFunctionReference(const JSITypedFunctionReference &) = delete;
+
+    JSITypedFunctionReference &
+    operator=(const JSITypedFunctionReference &) = delete;
+
+    static js_value_t *
+    call(js_env_t *env, js_callback_info_t *info) {
+      int err;
+
+      JSITypedFunctionReference *ref;
+
+      constexpr size_t arity = sizeof...(Args);
+
+      std::array<js_value_t *, arity> argv;
+
+      size_t argc = arity;
+      err = js_get_callback_info(env, info, &argc, argv.data(), nullptr, reinterpret_cast<void **>(&ref));
+      assert(err == 0);
+
+      if (argc < arity) {
+        auto message = "Expected " + std::to_string(arity) + " arguments";
+
+        err = js_throw_type_error(env, NULL, message.c_str());
+        assert(err == 0);
+
+        return nullptr;
+      }
+
+      JSICallbackScope scope(ref->runtime);
+
+      return ref->invoke(argv, std::index_sequence_for<Args...>());
+    }
+
+    // Called directly from optimized code with unboxed arguments. No handle
+    // scope is open and nothing may be thrown, which is why only noexcept
+    // callables over primitive types end up here.
+    static R
+    fastCall(js_value_t *receiver, std::decay_t<Args>... args, js_typed_callback_info_t *info) {
+      int err;
+
+      JSITypedFunctionReference *ref;
+      err = js_get_typed_callback_info(info, nullptr, reinterpret_cast<void **>(&ref));
+      assert(err == 0);
+
+      return ref->function(args...);
+    }
+
+    template <size_t... i>
+    js_value_t *
+    invoke(const std::array<js_value_t *, sizeof...(Args)> &argv, std::index_sequence<i...>) {
+      int err;
+
+      std::tuple<JSITypedStorage<Args>...> args;
+
+      if (!(runtime.toNative(argv[i], std::get<i>(args)) && ...)) return nullptr;
+
+      try {
+        if constexpr (std::is_void_v<R>) {
+          function(std::get<i>(args)...);
+
+          js_value_t *result;
+          err = js_get_undefined(runtime.env, &result);
+          assert(err == 0);
+
+          return result;
+        } else {
+          return runtime.fromNative(function(std::get<i>(args)...));
+        }
+      } catch (const jsi::JSError &error) {
+        err = js_throw(runtime.env, runtime.as(error));
+        assert(err == 0);
+
+        return nullptr;
+      } catch (const std::exception &error) {
+        err = js_throw_error(runtime.env, NULL, error.what());
+        assert(err == 0);
+
+        return nullptr;
+      }
+    }
+  };
+
+  template <typename F>
+  struct JSITypedSignature : JSITypedSignature<decltype(&F::operator())> {};
+
+  template <typename R, typename... Args>
+  struct JSITypedSignature<R (*)(Args...)> {
+    template <typename F>
+    using reference = JSITypedFunctionReference<F, R, Args...>;
+  };
+
+  template <typename C, typename R, typename... Args>
+  struct JSITypedSignature<R (C::*)(Args...)> : JSITypedSignature<R (*)(Args...)> {};
+
+  template <typename C, typename R, typename... Args>
+  struct JSITypedSignature<R (C::*)(Args...) const> : JSITypedSignature<R (*)(Args...)> {};
 };
@@ -0,0 +1,43 @@
+#include <assert.h>
+
+#include "../include/jsi.h"
+
+int
+main () {
+  JSIPlatform platform;
+
+  JSIRuntime runtime(platform);
+
+  jsi::Scope scope(runtime);
+
+  auto function = runtime
+                    .evaluateJavaScript(std::make_shared<jsi::StringBuffer>("(function (a, b) { if (a < 0) throw new Error('negative'); return this.base + a + b })"), "test.js")
+                    .asObject(runtime)
+                    .asFunction(runtime);
+
+  auto receiver = jsi::Object(runtime);
+
+  receiver.setProperty(runtime, "base", 100);
+
+  std::vector<jsi::Value> args;
+
+  for (int i = 0; i < 4; i++) {
+    args.emplace_back(i == 2 ? -1 : i);
+    args.emplace_back(i * 10);
+  }
+
+  auto results = runtime.callBatch(function, receiver, args.data(), 2, 4);
+
+  assert(results.size() == 4);
+
+  assert(!results[0].threw && results[0].value.getNumber() == 100);
+  assert(!results[1].threw && results[1].value.getNumber() == 111);
+  assert(!results[3].threw && results[3].value.getNumber() == 133);
+
+  assert(results[2].threw);
+  assert(results[2].value.getObject(runtime).getProperty(runtime, "message").getString(runtime).utf8(runtime) == "negative");
+
+  auto empty = runtime.callBatch(function, receiver, nullptr, 2, 0);
+
+  assert(empty.empty());
+}
@@ -0,0 +1,73 @@
+#include <assert.h>
+
+#include "../include/jsi.h"
+
+int
+main () {
+  JSIPlatform platform;
+
+  JSIRuntime runtime(platform);
+
+  auto function = runtime
+                    .evaluateJavaScript(std::make_shared<jsi::StringBuffer>("(function (a, b, c) { return this.base + a * 100 + b * 10 + (c || 0) })"), "test.js")
+                    .asObject(runtime)
+                    .asFunction(runtime);
+
+  auto receiver = jsi::Object(runtime);
+
+  receiver.setProperty(runtime, "base", 1000);
+
+  {
+    JSIRuntime::JSICallSite site(runtime, function, receiver, {1});
+
+    assert(site.call({2, 3}).getNumber() == 1123);
+    assert(site.call({4}).getNumber() == 1140);
+
+    {
+      jsi::Scope scope(runtime);
+
+      assert(site.call({5, 6}).getNumber() == 1156);
+
+      {
+        jsi::Scope scope(runtime);
+
+        assert(site.call({7, 8}).getNumber() == 1178);
+      }
+
+      assert(site.call({9, 1}).getNumber() == 1191);
+    }
+
+    assert(site.call({2, 2}).getNumber() == 1122);
+  }
+
+  {
+    JSIRuntime::JSICallSite site(runtime, function, receiver);
+
+    std::vector<jsi::Value> args;
+
+    args.emplace_back(1);
+    args.emplace_back(2);
+    args.emplace_back(3);
+
+    assert(site.call(args.data(), args.size()).getNumber() == 1123);
+  }
+
+  {
+    auto thrower = runtime
+                     .evaluateJavaScript(std::make_shared<jsi::StringBuffer>("(function () { throw new Error('fail') })"), "test.js")
+                     .asObject(runtime)
+                     .asFunction(runtime);
+
+    JSIRuntime::JSICallSite site(runtime, thrower, jsi::Value::undefined());
+
+    bool threw = false;
+
+    try {
+      site.call({});
+    } catch (const jsi::JSError &error) {
+      threw = true;
+    }
+
+    assert(threw);
+  }
+}
@@ -0,0 +1,68 @@
+#include <assert.h>
+
+#include "../include/jsi.h"
+
+struct Buffer : jsi::MutableBuffer {
+  uint8_t bytes[16];
+
+  size_t
+  size () const override {
+    return sizeof(bytes);
+  }
+
+  uint8_t *
+  data () override {
+    return bytes;
+  }
+};
+
+int
+main () {
+  JSIPlatform platform;
+
+  JSIRuntime runtime(platform);
+
+  jsi::Scope scope(runtime);
+
+  auto object = jsi::Object(runtime);
+  assert(runtime.classify(object) == 0);
+
+  auto array = jsi::Array(runtime, 2);
+  assert(runtime.classify(array) == JSIRuntime::JSIArrayKind);
+  assert(array.isArray(runtime));
+  assert(!array.isFunction(runtime));
+
+  auto arraybuffer = jsi::ArrayBuffer(runtime, std::make_shared<Buffer>());
+  assert(runtime.classify(arraybuffer) == JSIRuntime::JSIArrayBufferKind);
+  assert(arraybuffer.isArrayBuffer(runtime));
+
+  auto host = std::make_shared<jsi::HostObject>();
+
+  auto hostObject = jsi::Object::createFromHostObject(runtime, host);
+  assert(runtime.classify(hostObject) == JSIRuntime::JSIHostObjectKind);
+  assert(hostObject.isHostObject(runtime));
+
+  auto hostFunction = jsi::Function::createFromHostFunction(
+    runtime,
+    jsi::PropNameID::forAscii(runtime, "fn"),
+    0,
+    [] (jsi::Runtime &rt, const jsi::Value &receiver, const jsi::Value *args, size_t count) -> jsi::Value {
+      return jsi::Value::undefined();
+    }
+  );
+
+  assert(runtime.classify(hostFunction) == (JSIRuntime::JSIFunctionKind | JSIRuntime::JSIHostFunctionKind));
+
+  object.setProperty(runtime, "array", array);
+  object.setProperty(runtime, "function", hostFunction);
+
+  auto value = object.getProperty(runtime, "array").asObject(runtime);
+  assert(value.isArray(runtime));
+  assert(!value.isFunction(runtime));
+  assert(!value.isHostObject(runtime));
+
+  auto function = object.getProperty(runtime, "function").asObject(runtime);
+  assert(function.isFunction(runtime));
+  assert(!function.isArray(runtime));
+  assert(function.asFunction(runtime).isHostFunction(runtime));
+}
@@ -0,0 +1,107 @@
+#include <assert.h>
+
+#include "../include/jsi.h"
+
+struct Point : jsi::NativeState {
+  double x;
+  double y;
+
+  Point(double x, double y) : x(x), y(y) {}
+};
+
+static std::shared_ptr<Point>
+point (jsi::Runtime &rt, const jsi::Value &receiver) {
+  return receiver.getObject(rt).getNativeState<Point>(rt);
+}
+
+int
+main () {
+  JSIPlatform platform;
+
+  JSIRuntime runtime(platform);
+
+  jsi::Scope scope(runtime);
+
+  std::vector<JSIRuntime::JSIHostMethod> methods;
+
+  methods.push_back({"length", 0, [] (jsi::Runtime &rt, const jsi::Value &receiver, const jsi::Value *args, size_t count) -> jsi::Value {
+    auto p = point(rt, receiver);
+
+    return jsi::Value(std::sqrt(p->x * p->x + p->y * p->y));
+  }});
+
+  std::vector<JSIRuntime::JSIHostAccessor> accessors;
+
+  accessors.push_back({
+    "x",
+    [] (jsi::Runtime &rt, const jsi::Value &receiver, const jsi::Value *args, size_t count) -> jsi::Value {
+      return jsi::Value(point(rt, receiver)->x);
+    },
+    [] (jsi::Runtime &rt, const jsi::Value &receiver, const jsi::Value *args, size_t count) -> jsi::Value {
+      if (count > 0) point(rt, receiver)->x = args[0].getNumber();
+
+      return jsi::Value::undefined();
+    },
+  });
+
+  accessors.push_back({
+    "y",
+    [] (jsi::Runtime &rt, const jsi::Value &receiver, const jsi::Value *args, size_t count) -> jsi::Value {
+      return jsi::Value(point(rt, receiver)->y);
+    },
+    nullptr,
+  });
+
+  auto constructor = runtime.createHostClass(jsi::PropNameID::forAscii(runtime, "Point"), std::move(methods), std::move(accessors));
+
+  auto a = runtime.createHostInstance(constructor, std::make_shared<Point>(3, 4));
+  auto b = runtime.createHostInstance(constructor, std::make_shared<Point>(6, 8));
+
+  assert(a.hasNativeState(runtime));
+  assert(a.instanceOf(runtime, constructor));
+
+  assert(a.getPropertyAsFunction(runtime, "length").callWithThis(runtime, a).getNumber() == 5);
+  assert(b.getPropertyAsFunction(runtime, "length").callWithThis(runtime, b).getNumber() == 10);
+
+  auto sum = runtime
+               .evaluateJavaScript(std::make_shared<jsi::StringBuffer>("(function (a, b) { a.x = 0; return a.length() + b.length() + a.y })"), "test.js")
+               .asObject(runtime)
+               .asFunction(runtime);
+
+  assert(sum.call(runtime, a, b).getNumber() == 18);
+
+  assert(a.getProperty(runtime, "x").getNumber() == 0);
+  assert(b.getProperty(runtime, "x").getNumber() == 6);
+
+  assert(jsi::Value::strictEquals(runtime, a.getProperty(runtime, "length"), b.getProperty(runtime, "length")));
+
+  auto other = runtime.createHostClass(jsi::PropNameID::forAscii(runtime, "Other"), {});
+
+  auto c = runtime.createHostInstance(other, std::make_shared<Point>(1, 1));
+
+  auto d = jsi::Object(runtime);
+
+  d.setNativeState(runtime, std::make_shared<Point>(1, 1));
+
+  auto check = runtime
+                 .evaluateJavaScript(std::make_shared<jsi::StringBuffer>(
+                                       "(function (Point, a, c, d) {\n"
+                                       "  const x = Object.getOwnPropertyDescriptor(Point.prototype, 'x')\n"
+                                       "  const y = Object.getOwnPropertyDescriptor(Point.prototype, 'y')\n"
+                                       "  if (y.set !== undefined) return false\n"
+                                       "  if (x.get.call(a) !== 0) return false\n"
+                                       "  if (x.set.call(a) !== undefined || x.get.call(a) !== 0) return false\n"
+                                       "  if (x.set.call(a, 2) !== undefined || x.get.call(a) !== 2) return false\n"
+                                       "  const p = new Point()\n"
+                                       "  for (const f of [() => p.length(), () => p.x, () => { p.x = 1 }, () => x.get.call({}), () => a.length.call(c), () => a.length.call(d)]) {\n"
+                                       "    try { f(); return false } catch (err) { if (!(err instanceof TypeError)) return false }\n"
+                                       "  }\n"
+                                       "  return true\n"
+                                       "})"
+                                     ),
+                                     "test.js")
+                 .asObject(runtime)
+                 .asFunction(runtime);
+
+  assert(check.call(runtime, constructor, a, c, d).getBool());
+}
@@ -0,0 +1,40 @@
+#include <assert.h>
+
+#include "../include/jsi.h"
+
+int
+main () {
+  JSIPlatform platform;
+
+  JSIRuntime runtime(platform);
+
+  jsi::Scope scope(runtime);
+
+  auto host = [] (jsi::Runtime &rt, const jsi::Value &receiver, const jsi::Value *args, size_t count) -> jsi::Value {
+    double sum = 0;
+
+    for (size_t i = 0; i < count; i++) {
+      sum += args[i].getNumber();
+    }
+
+    return jsi::Value(sum);
+  };
+
+  std::vector<jsi::Value> args;
+
+  for (int i = 1; i <= 32; i++) {
+    args.emplace_back(i);
+  }
+
+  const jsi::Value *values = args.data();
+
+  for (unsigned int declared : {0, 2, 4, 8, 16, 24}) {
+    auto function = jsi::Function::createFromHostFunction(runtime, jsi::PropNameID::forAscii(runtime, "sum"), declared, host);
+
+    for (size_t count : {0, 1, 2, 4, 5, 8, 9, 16, 17, 32}) {
+      auto result = function.call(runtime, values, count);
+
+      assert(result.getNumber() == count * (count + 1) / 2);
+    }
+  }
+}
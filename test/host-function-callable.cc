@@ -0,0 +1,59 @@
+#include <assert.h>
+
+#include "../include/jsi.h"
+
+static jsi::Value
+add (jsi::Runtime &rt, const jsi::Value &receiver, const jsi::Value *args, size_t count, void *data) {
+  auto calls = static_cast<int *>(data);
+
+  (*calls)++;
+
+  return jsi::Value(args[0].getNumber() + args[1].getNumber());
+}
+
+int
+main () {
+  JSIPlatform platform;
+
+  JSIRuntime runtime(platform);
+
+  jsi::Scope scope(runtime);
+
+  {
+    int calls = 0;
+
+    auto function = runtime.createFunctionFromPointer(jsi::PropNameID::forAscii(runtime, "add"), 2, add, &calls);
+
+    assert(function.call(runtime, 1, 2).getNumber() == 3);
+    assert(function.call(runtime, 3, 4).getNumber() == 7);
+    assert(calls == 2);
+
+    assert(!function.isHostFunction(runtime));
+  }
+
+  {
+    auto offset = std::make_unique<double>(10);
+
+    auto function = runtime.createFunctionFromCallable(jsi::PropNameID::forAscii(runtime, "offset"), 1, [offset = std::move(offset)] (jsi::Runtime &rt, const jsi::Value &receiver, const jsi::Value *args, size_t count) -> jsi::Value {
+      return jsi::Value(*offset + args[0].getNumber());
+    });
+
+    assert(function.call(runtime, 5).getNumber() == 15);
+  }
+
+  {
+    auto function = runtime.createFunctionFromCallable(jsi::PropNameID::forAscii(runtime, "fail"), 0, [] (jsi::Runtime &rt, const jsi::Value &receiver, const jsi::Value *args, size_t count) -> jsi::Value {
+      throw jsi::JSError(rt, "fail");
+    });
+
+    bool threw = false;
+
+    try {
+      function.call(runtime);
+    } catch (const jsi::JSError &error) {
+      threw = true;
+    }
+
+    assert(threw);
+  }
+}
@@ -0,0 +1,46 @@
+#include <assert.h>
+
+#include "../include/jsi.h"
+
+int
+main () {
+  JSIPlatform platform;
+
+  JSIRuntime runtime(platform);
+
+  jsi::Scope scope(runtime);
+
+  auto host = [] (JSIRuntime &rt, const JSIRuntime::JSIArguments &args) -> jsi::Value {
+    assert(args.size() == 3);
+
+    assert(args[0].isNumber());
+    assert(args[0].getNumber() == 42);
+
+    assert(args[1].isString());
+    assert(args[1].utf8() == "hello");
+
+    assert(args[2].isObject());
+
+    auto object = args[2].toValue().asObject(rt);
+
+    assert(object.getProperty(rt, "answer").getNumber() == 42);
+
+    assert(args.self().isObject());
+
+    return args.thisValue();
+  };
+
+  auto function = runtime.createFunction(jsi::PropNameID::forAscii(runtime, "fn"), 3, host);
+
+  assert(!function.isHostFunction(runtime));
+
+  auto object = jsi::Object(runtime);
+
+  object.setProperty(runtime, "answer", 42);
+
+  auto receiver = jsi::Object(runtime);
+
+  auto result = function.callWithThis(runtime, receiver, 42, jsi::String::createFromAscii(runtime, "hello"), object);
+
+  assert(jsi::Value::strictEquals(runtime, result, jsi::Value(runtime, receiver)));
+}
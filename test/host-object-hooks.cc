@@ -0,0 +1,80 @@
+#include <assert.h>
+
+#include "../include/jsi.h"
+
+struct HostObject : JSIHostObject {
+  int gets = 0;
+  int deletes = 0;
+
+  jsi::Value
+  get (jsi::Runtime &runtime, const jsi::PropNameID &name) override {
+    gets++;
+
+    return jsi::Value(42);
+  }
+
+  bool
+  has (jsi::Runtime &runtime, const jsi::PropNameID &name) override {
+    return name.utf8(runtime) == "foo";
+  }
+
+  bool
+  deleteProperty (jsi::Runtime &runtime, const jsi::PropNameID &name) override {
+    deletes++;
+
+    return name.utf8(runtime) == "foo";
+  }
+};
+
+struct DefaultHostObject : JSIHostObject {
+  int gets = 0;
+
+  jsi::Value
+  get (jsi::Runtime &runtime, const jsi::PropNameID &name) override {
+    gets++;
+
+    return jsi::Value(42);
+  }
+};
+
+int
+main () {
+  JSIPlatform platform;
+
+  JSIRuntime runtime(platform);
+
+  jsi::Scope scope(runtime);
+
+  auto host = std::make_shared<HostObject>();
+
+  auto object = jsi::Object::createFromHostObject(runtime, host);
+
+  assert(object.hasProperty(runtime, "foo"));
+  assert(!object.hasProperty(runtime, "bar"));
+
+  auto check = runtime
+                 .evaluateJavaScript(std::make_shared<jsi::StringBuffer>("(function (o) { return ('foo' in o) && !('bar' in o) && delete o.foo })"), "test.js")
+                 .asObject(runtime)
+                 .asFunction(runtime);
+
+  assert(check.call(runtime, object).getBool());
+
+  assert(host->gets == 0);
+  assert(host->deletes == 1);
+
+  assert(object.getProperty(runtime, "foo").getNumber() == 42);
+  assert(host->gets == 1);
+
+  auto defaults = std::make_shared<DefaultHostObject>();
+
+  auto other = jsi::Object::createFromHostObject(runtime, defaults);
+
+  auto fallback = runtime
+                    .evaluateJavaScript(std::make_shared<jsi::StringBuffer>("(function (o) { return ('foo' in o) && !(delete o.foo) })"), "test.js")
+                    .asObject(runtime)
+                    .asFunction(runtime);
+
+  assert(fallback.call(runtime, other).getBool());
+
+  assert(defaults->gets == 1);
+}
@@ -0,0 +1,74 @@
+#include <assert.h>
+
+#include "../include/jsi.h"
+
+struct HostObject : jsi::HostObject {
+  int enumerations = 0;
+
+  std::vector<std::string> names = {"a", "b", "c"};
+
+  jsi::Value
+  get (jsi::Runtime &runtime, const jsi::PropNameID &id) override {
+    return jsi::Value(1);
+  }
+
+  std::vector<jsi::PropNameID>
+  getPropertyNames (jsi::Runtime &runtime) override {
+    enumerations++;
+
+    std::vector<jsi::PropNameID> result;
+
+    for (auto &name : names) {
+      result.push_back(jsi::PropNameID::forUtf8(runtime, name));
+    }
+
+    return result;
+  }
+};
+
+int
+main () {
+  JSIPlatform platform;
+
+  JSIRuntime runtime(platform);
+
+  jsi::Scope scope(runtime);
+
+  auto host = std::make_shared<HostObject>();
+
+  auto object = jsi::Object::createFromHostObject(runtime, host);
+
+  auto keys = runtime
+                .evaluateJavaScript(std::make_shared<jsi::StringBuffer>("(function (o) { return Object.keys(o).join() })"), "test.js")
+                .asObject(runtime)
+                .asFunction(runtime);
+
+  auto join = [&] () {
+    return keys.call(runtime, object).getString(runtime).utf8(runtime);
+  };
+
+  assert(join() == "a,b,c");
+  assert(join() == "a,b,c");
+  assert(host->enumerations == 2);
+
+  runtime.setHostObjectKeysCached(object, true);
+
+  assert(join() == "a,b,c");
+  assert(join() == "a,b,c");
+  assert(host->enumerations == 3);
+
+  host->names.push_back("d");
+
+  assert(join() == "a,b,c");
+
+  runtime.invalidateHostObjectKeys(object);
+
+  assert(join() == "a,b,c,d");
+  assert(join() == "a,b,c,d");
+  assert(host->enumerations == 4);
+
+  runtime.setHostObjectKeysCached(object, false);
+
+  assert(join() == "a,b,c,d");
+  assert(host->enumerations == 5);
+}
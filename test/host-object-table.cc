@@ -0,0 +1,88 @@
+#include <assert.h>
+
+#include "../include/jsi.h"
+
+struct Counter : JSIRuntime::JSIStaticHostObject<Counter> {
+  double count = 0;
+
+  using JSIStaticHostObject::JSIStaticHostObject;
+};
+
+static const std::string long_name(80, 'l');
+
+int
+main () {
+  JSIPlatform platform;
+
+  JSIRuntime runtime(platform);
+
+  jsi::Scope scope(runtime);
+
+  auto table = std::make_shared<JSIRuntime::JSIHostObjectTable<Counter>>(runtime);
+
+  table
+    ->property(
+      "count",
+      [] (jsi::Runtime &rt, Counter &counter) -> jsi::Value {
+        return jsi::Value(counter.count);
+      },
+      [] (jsi::Runtime &rt, Counter &counter, const jsi::Value &value) {
+        counter.count = value.getNumber();
+      }
+    )
+    .property("name", [] (jsi::Runtime &rt, Counter &counter) -> jsi::Value {
+      return jsi::String::createFromAscii(rt, "counter");
+    })
+    .property(long_name, [] (jsi::Runtime &rt, Counter &counter) -> jsi::Value {
+      return jsi::Value(42);
+    })
+    .method("increment", 1, [] (jsi::Runtime &rt, Counter &counter, const jsi::Value *args, size_t count) -> jsi::Value {
+      counter.count += count > 0 ? args[0].getNumber() : 1;
+
+      return jsi::Value(counter.count);
+    });
+
+  auto a = std::make_shared<Counter>(table);
+  auto b = std::make_shared<Counter>(table);
+
+  auto x = jsi::Object::createFromHostObject(runtime, a);
+  auto y = jsi::Object::createFromHostObject(runtime, b);
+
+  auto run = runtime
+               .evaluateJavaScript(std::make_shared<jsi::StringBuffer>("(function (x, y) { x.count = 10; x.increment(); x.increment(5); y.increment(); return x.increment === y.increment })"), "test.js")
+               .asObject(runtime)
+               .asFunction(runtime);
+
+  assert(run.call(runtime, x, y).getBool());
+
+  assert(a->count == 16);
+  assert(b->count == 1);
+
+  assert(x.getProperty(runtime, "name").getString(runtime).utf8(runtime) == "counter");
+  assert(x.getProperty(runtime, "missing").isUndefined());
+  assert(x.getProperty(runtime, long_name.c_str()).getNumber() == 42);
+
+  bool threw = false;
+
+  try {
+    x.setProperty(runtime, "name", 1);
+  } catch (const jsi::JSError &error) {
+    threw = true;
+  }
+
+  assert(threw);
+
+  threw = false;
+
+  try {
+    x.getPropertyAsFunction(runtime, "increment").call(runtime);
+  } catch (const jsi::JSError &error) {
+    threw = error.value().getObject(runtime).instanceOf(runtime, runtime.global().getPropertyAsFunction(runtime, "TypeError"));
+  }
+
+  assert(threw);
+
+  auto names = x.getPropertyNames(runtime);
+
+  assert(names.size(runtime) == 4);
+}
@@ -0,0 +1,70 @@
+#include <assert.h>
+#include <string.h>
+
+#include "../include/jsi.h"
+
+int
+main () {
+  JSIPlatform platform;
+
+  JSIRuntime runtime(platform);
+
+  jsi::Scope scope(runtime);
+
+  runtime.setLazyErrors(true);
+  runtime.setStackTraceLimit(2);
+
+  auto source = std::make_shared<jsi::StringBuffer>("function fail () { throw new Error('fail') }; fail()");
+
+  try {
+    runtime.evaluateJavaScript(source, "test.js");
+
+    assert(false);
+  } catch (const JSIRuntime::JSIError &error) {
+    assert(error.getMessage().empty());
+
+    assert(error.message() == "fail");
+    assert(error.stack().find("fail") != std::string::npos);
+    assert(strncmp(error.what(), "fail", 4) == 0);
+
+    assert(error.value().isObject());
+  }
+
+  try {
+    runtime.evaluateJavaScript(std::make_shared<jsi::StringBuffer>("throw 42"), "test.js");
+
+    assert(false);
+  } catch (const JSIRuntime::JSIError &error) {
+    assert(error.message() == "42");
+    assert(error.stack() == "no stack");
+  }
+
+  auto coerced = std::make_shared<jsi::StringBuffer>("throw { message: 42 }");
+
+  try {
+    runtime.evaluateJavaScript(coerced, "test.js");
+
+    assert(false);
+  } catch (const JSIRuntime::JSIError &error) {
+    assert(error.message() == "42");
+  }
+
+  runtime.setLazyErrors(false);
+
+  try {
+    runtime.evaluateJavaScript(source, "test.js");
+
+    assert(false);
+  } catch (const JSIRuntime::JSIError &error) {
+    assert(error.getMessage() == "fail");
+    assert(error.message() == "fail");
+  }
+
+  try {
+    runtime.evaluateJavaScript(coerced, "test.js");
+
+    assert(false);
+  } catch (const JSIRuntime::JSIError &error) {
+    assert(error.getMessage() == "42");
+  }
+}
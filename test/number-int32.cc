@@ -0,0 +1,43 @@
+#include <assert.h>
+#include <math.h>
+
+#include "../include/jsi.h"
+
+int
+main () {
+  JSIPlatform platform;
+
+  JSIRuntime runtime(platform);
+
+  jsi::Scope scope(runtime);
+
+  auto toInt32 = runtime.createFunction(jsi::PropNameID::forAscii(runtime, "toInt32"), 1, [] (JSIRuntime &rt, const JSIRuntime::JSIArguments &args) -> jsi::Value {
+    return jsi::Value(args[0].getInt32());
+  });
+
+  auto toUint32 = runtime.createFunction(jsi::PropNameID::forAscii(runtime, "toUint32"), 1, [] (JSIRuntime &rt, const JSIRuntime::JSIArguments &args) -> jsi::Value {
+    return jsi::Value(static_cast<double>(args[0].getUint32()));
+  });
+
+  assert(toInt32.call(runtime, 42).getNumber() == 42);
+  assert(toInt32.call(runtime, -3.7).getNumber() == -3);
+  assert(toInt32.call(runtime, 4294967301.0).getNumber() == 5);
+  assert(toInt32.call(runtime, 2147483648.0).getNumber() == INT32_MIN);
+  assert(toInt32.call(runtime, NAN).getNumber() == 0);
+  assert(toUint32.call(runtime, -1).getNumber() == UINT32_MAX);
+
+  auto echo = jsi::Function::createFromHostFunction(
+    runtime,
+    jsi::PropNameID::forAscii(runtime, "echo"),
+    1,
+    [] (jsi::Runtime &rt, const jsi::Value &receiver, const jsi::Value *args, size_t count) -> jsi::Value {
+      return jsi::Value(rt, args[0]);
+    }
+  );
+
+  assert(echo.call(runtime, 7).getNumber() == 7);
+  assert(echo.call(runtime, -7).getNumber() == -7);
+  assert(echo.call(runtime, 3000000000.0).getNumber() == 3000000000.0);
+  assert(echo.call(runtime, 0.5).getNumber() == 0.5);
+  assert(std::signbit(echo.call(runtime, -0.0).getNumber()));
+}
@@ -0,0 +1,32 @@
+#include <assert.h>
+
+#include "../include/jsi.h"
+
+int
+main () {
+  JSIPlatform platform;
+
+  JSIRuntime runtime(platform);
+
+  jsi::Scope scope(runtime);
+
+  auto string = jsi::String::createFromAscii(runtime, "hello");
+
+  auto live = runtime.pointerValueStats().live;
+
+  std::vector<jsi::Value> copies;
+
+  for (int i = 0; i < 16; i++) {
+    copies.emplace_back(runtime, string);
+  }
+
+  assert(runtime.pointerValueStats().live == live);
+
+  auto name = jsi::PropNameID::forString(runtime, string);
+  assert(name.utf8(runtime) == "hello");
+
+  copies.clear();
+
+  assert(string.utf8(runtime) == "hello");
+  assert(runtime.pointerValueStats().live == live);
+}
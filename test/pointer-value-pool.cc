@@ -0,0 +1,36 @@
+#include <assert.h>
+
+#include "../include/jsi.h"
+
+int
+main () {
+  JSIPlatform platform;
+
+  JSIRuntime runtime(platform);
+
+  jsi::Scope scope(runtime);
+
+  auto live = runtime.pointerValueStats().live;
+
+  for (int i = 0; i < 1000; i++) {
+    auto object = jsi::Object(runtime);
+
+    auto copy = jsi::Value(runtime, object);
+    assert(copy.isObject());
+  }
+
+  auto &stats = runtime.pointerValueStats();
+
+  assert(stats.live == live);
+  assert(stats.hits >= 999);
+  assert(stats.slabs == 1);
+
+  auto object = jsi::Object(runtime);
+
+  auto weak = jsi::WeakObject(runtime, object);
+  assert(runtime.weakPointerValueStats().live == 1);
+
+  auto locked = weak.lock(runtime);
+  assert(locked.isObject());
+  assert(jsi::Value::strictEquals(runtime, locked, jsi::Value(runtime, object)));
+}
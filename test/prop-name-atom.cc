@@ -0,0 +1,79 @@
+#include <assert.h>
+
+#include "../include/jsi.h"
+
+static uint32_t foo;
+static uint32_t bar;
+
+struct HostObject : JSIHostObject {
+  int gets = 0;
+
+  HostObject() : JSIHostObject(true) {}
+
+  jsi::Value
+  get (jsi::Runtime &rt, const jsi::PropNameID &name) override {
+    auto &runtime = static_cast<JSIRuntime &>(rt);
+
+    gets++;
+
+    auto atom = runtime.atom(name);
+
+    if (atom == foo) return jsi::Value(1);
+    if (atom == bar) return jsi::Value(2);
+
+    return jsi::String::createFromUtf8(rt, name.utf8(rt));
+  }
+};
+
+struct PlainHostObject : jsi::HostObject {
+  jsi::Value
+  get (jsi::Runtime &rt, const jsi::PropNameID &name) override {
+    auto &runtime = static_cast<JSIRuntime &>(rt);
+
+    return jsi::Value(static_cast<double>(runtime.atom(name)));
+  }
+};
+
+int
+main () {
+  JSIPlatform platform;
+
+  JSIRuntime runtime(platform);
+
+  jsi::Scope scope(runtime);
+
+  foo = runtime.intern("foo");
+  bar = runtime.intern("bar");
+
+  assert(foo != 0);
+  assert(bar != 0);
+  assert(foo != bar);
+  assert(runtime.intern("foo") == foo);
+
+  auto host = std::make_shared<HostObject>();
+
+  auto object = jsi::Object::createFromHostObject(runtime, host);
+
+  assert(object.getProperty(runtime, "foo").getNumber() == 1);
+  assert(object.getProperty(runtime, "bar").getNumber() == 2);
+  assert(object.getProperty(runtime, "baz").getString(runtime).utf8(runtime) == "baz");
+
+  auto sum = runtime
+               .evaluateJavaScript(std::make_shared<jsi::StringBuffer>("(function (o) { let sum = 0; for (let i = 0; i < 100; i++) sum += o.foo + o.bar; return sum })"), "test.js")
+               .asObject(runtime)
+               .asFunction(runtime);
+
+  assert(sum.call(runtime, object).getNumber() == 300);
+
+  auto plain = jsi::Object::createFromHostObject(runtime, std::make_shared<PlainHostObject>());
+
+  assert(plain.getProperty(runtime, "foo").getNumber() == 0);
+  assert(plain.getProperty(runtime, "baz").getNumber() == 0);
+
+  auto a = jsi::PropNameID::forAscii(runtime, "foo");
+  auto b = jsi::PropNameID::forAscii(runtime, "foo");
+
+  assert(runtime.atom(a) == 0);
+  assert(runtime.intern("baz") == bar + 1);
+  assert(jsi::PropNameID::compare(runtime, a, b));
+}
@@ -0,0 +1,48 @@
+#include <assert.h>
+
+#include "../include/jsi.h"
+
+int
+main () {
+  JSIPlatform platform;
+
+  JSIRuntime runtime(platform);
+
+  runtime.setReleaseThreshold(4);
+
+  {
+    std::vector<jsi::Object> objects;
+
+    for (int i = 0; i < 3; i++) {
+      objects.emplace_back(runtime);
+    }
+  }
+
+  assert(runtime.pendingReleases() == 3);
+
+  runtime.flushReleases();
+
+  assert(runtime.pendingReleases() == 0);
+
+  {
+    std::vector<jsi::Object> objects;
+
+    for (int i = 0; i < 4; i++) {
+      objects.emplace_back(runtime);
+    }
+  }
+
+  assert(runtime.pendingReleases() == 0);
+
+  auto object = std::make_unique<jsi::Object>(runtime);
+
+  {
+    jsi::Scope scope(runtime);
+
+    object.reset();
+
+    assert(runtime.pendingReleases() == 1);
+  }
+
+  assert(runtime.pendingReleases() == 0);
+}
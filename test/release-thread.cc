@@ -0,0 +1,36 @@
+#include <assert.h>
+#include <thread>
+
+#include "../include/jsi.h"
+
+int
+main () {
+  JSIPlatform platform;
+
+  JSIRuntime runtime(platform);
+
+  jsi::Scope scope(runtime);
+
+  auto live = runtime.pointerValueStats().live;
+
+  auto object = std::make_shared<jsi::Object>(runtime);
+
+  auto weak = std::make_shared<jsi::WeakObject>(runtime, *object);
+
+  std::thread thread([object = std::move(object), weak = std::move(weak)] () mutable {
+    object.reset();
+    weak.reset();
+  });
+
+  thread.join();
+
+  assert(runtime.pointerValueStats().live == live + 1);
+  assert(runtime.weakPointerValueStats().live == 1);
+
+  {
+    jsi::Scope inner(runtime);
+  }
+
+  assert(runtime.pointerValueStats().live == live);
+  assert(runtime.weakPointerValueStats().live == 0);
+}
@@ -0,0 +1,35 @@
+#include <assert.h>
+
+#include "../include/jsi.h"
+
+int
+main () {
+  JSIPlatform platform;
+
+  JSIRuntime runtime(platform);
+
+  jsi::Scope scope(runtime);
+
+  auto object = jsi::Object(runtime);
+
+  object.setProperty(runtime, "foo", jsi::String::createFromAscii(runtime, "bar"));
+
+  jsi::Value escaped;
+
+  {
+    jsi::Scope scope(runtime);
+
+    auto value = object.getProperty(runtime, "foo");
+
+    auto copy = jsi::Value(runtime, value);
+    assert(copy.isString());
+
+    escaped = std::move(copy);
+  }
+
+  assert(escaped.isString());
+  assert(escaped.getString(runtime).utf8(runtime) == "bar");
+
+  auto copy = jsi::Value(runtime, escaped);
+  assert(copy.getString(runtime).utf8(runtime) == "bar");
+}
@@ -0,0 +1,81 @@
+#include <assert.h>
+
+#include "../include/jsi.h"
+
+int
+main () {
+  JSIPlatform platform;
+
+  JSIRuntime runtime(platform);
+
+  jsi::Scope scope(runtime);
+
+  {
+    auto result = runtime.tryEvaluateJavaScript(std::make_shared<jsi::StringBuffer>("1 + 2"), "test.js");
+
+    assert(result);
+    assert(result.value.getNumber() == 3);
+  }
+
+  {
+    auto result = runtime.tryEvaluateJavaScript(std::make_shared<jsi::StringBuffer>("throw new Error('fail')"), "test.js");
+
+    assert(!result);
+    assert(result.value.getObject(runtime).getProperty(runtime, "message").getString(runtime).utf8(runtime) == "fail");
+  }
+
+  auto object = runtime
+                  .evaluateJavaScript(std::make_shared<jsi::StringBuffer>("({ get fail () { throw 1 }, ok: 2 })"), "test.js")
+                  .asObject(runtime);
+
+  {
+    auto result = runtime.tryGetProperty(object, jsi::PropNameID::forAscii(runtime, "ok"));
+
+    assert(result && result.value.getNumber() == 2);
+
+    result = runtime.tryGetProperty(object, jsi::String::createFromAscii(runtime, "fail"));
+
+    assert(!result && result.value.getNumber() == 1);
+  }
+
+  auto function = runtime
+                    .evaluateJavaScript(std::make_shared<jsi::StringBuffer>("(function (a) { if (a) throw a; this.ok = true; return 3 })"), "test.js")
+                    .asObject(runtime)
+                    .asFunction(runtime);
+
+  {
+    jsi::Value args[] = {jsi::Value(0)};
+
+    auto result = runtime.tryCall(function, jsi::Value::undefined(), args, 1);
+
+    assert(result && result.value.getNumber() == 3);
+
+    args[0] = jsi::Value(4);
+
+    result = runtime.tryCall(function, jsi::Value::undefined(), args, 1);
+
+    assert(!result && result.value.getNumber() == 4);
+
+    result = runtime.tryCallAsConstructor(function, args, 1);
+
+    assert(!result && result.value.getNumber() == 4);
+
+    result = runtime.tryCallAsConstructor(function, nullptr, 0);
+
+    assert(result && result.value.getObject(runtime).getProperty(runtime, "ok").getBool());
+  }
+
+  {
+    bool threw = false;
+
+    try {
+      object.getProperty(runtime, "fail");
+    } catch (const jsi::JSError &error) {
+      threw = true;
+
+      assert(error.value().getNumber() == 1);
+    }
+
+    assert(threw);
+  }
+}
@@ -0,0 +1,113 @@
+#include <assert.h>
+
+#include "../include/jsi.h"
+
+struct Buffer : jsi::MutableBuffer {
+  uint8_t bytes[4] = {1, 2, 3, 4};
+
+  size_t
+  size() const override {
+    return sizeof(bytes);
+  }
+
+  uint8_t *
+  data() override {
+    return bytes;
+  }
+};
+
+static double
+add (double a, double b) {
+  return a + b;
+}
+
+int
+main () {
+  JSIPlatform platform;
+
+  JSIRuntime runtime(platform);
+
+  jsi::Scope scope(runtime);
+
+  {
+    auto function = runtime.createTypedFunction(jsi::PropNameID::forAscii(runtime, "add"), add);
+
+    assert(function.call(runtime, 1, 2).getNumber() == 3);
+  }
+
+  {
+    auto function = runtime.createTypedFunction(jsi::PropNameID::forAscii(runtime, "scale"), [] (int32_t a, double b) noexcept -> double {
+      return a * b;
+    });
+
+    auto loop = runtime
+                  .evaluateJavaScript(std::make_shared<jsi::StringBuffer>("(function (scale) { let sum = 0; for (let i = 0; i < 10000; i++) sum += scale(i % 4, 0.5); return sum })"), "test.js")
+                  .asObject(runtime)
+                  .asFunction(runtime);
+
+    assert(loop.call(runtime, function).getNumber() == 7500);
+
+    bool threw = false;
+
+    try {
+      function.call(runtime, jsi::String::createFromAscii(runtime, "1"), 2);
+    } catch (const jsi::JSError &error) {
+      threw = true;
+    }
+
+    assert(threw);
+  }
+
+  {
+    auto function = runtime.createTypedFunction(jsi::PropNameID::forAscii(runtime, "length"), [] (std::string_view str) -> int32_t {
+      return static_cast<int32_t>(str.length());
+    });
+
+    assert(function.call(runtime, jsi::String::createFromAscii(runtime, "hello")).getNumber() == 5);
+
+    bool threw = false;
+
+    try {
+      function.call(runtime, 42);
+    } catch (const jsi::JSError &error) {
+      threw = true;
+    }
+
+    assert(threw);
+
+    threw = false;
+
+    try {
+      function.call(runtime);
+    } catch (const jsi::JSError &error) {
+      threw = true;
+    }
+
+    assert(threw);
+  }
+
+  {
+    size_t sum = 0;
+
+    auto function = runtime.createTypedFunction(jsi::PropNameID::forAscii(runtime, "sum"), [&sum] (std::span<uint8_t> buffer) {
+      for (auto byte : buffer) sum += byte;
+    });
+
+    auto buffer = std::make_shared<Buffer>();
+
+    auto result = function.call(runtime, jsi::ArrayBuffer(runtime, buffer));
+
+    assert(result.isUndefined());
+    assert(sum == 10);
+  }
+
+  {
+    auto function = runtime.createTypedFunction(jsi::PropNameID::forAscii(runtime, "greet"), [] (const std::string &name, bool loud) -> std::string {
+      return (loud ? "HELLO " : "hello ") + name;
+    });
+
+    auto result = function.call(runtime, jsi::String::createFromAscii(runtime, "world"), true);
+
+    assert(result.getString(runtime).utf8(runtime) == "HELLO world");
+  }
+}
@@ -0,0 +1,34 @@
+#include <assert.h>
+
+#include "../include/jsi.h"
+
+int
+main () {
+  JSIPlatform platform;
+
+  JSIRuntime runtime(platform);
+
+  jsi::Scope scope(runtime);
+
+  auto echo = jsi::Function::createFromHostFunction(
+    runtime,
+    jsi::PropNameID::forAscii(runtime, "echo"),
+    1,
+    [] (jsi::Runtime &rt, const jsi::Value &receiver, const jsi::Value *args, size_t count) -> jsi::Value {
+      return jsi::Value(rt, args[0]);
+    }
+  );
+
+  for (int i = 0; i < 2; i++) {
+    jsi::Scope scope(runtime);
+
+    assert(echo.call(runtime, jsi::Value::undefined()).isUndefined());
+    assert(echo.call(runtime, jsi::Value::null()).isNull());
+    assert(echo.call(runtime, true).getBool() == true);
+    assert(echo.call(runtime, false).getBool() == false);
+    assert(echo.call(runtime, 42).getNumber() == 42);
+    assert(echo.call(runtime, "hello").getString(runtime).utf8(runtime) == "hello");
+  }
+
+  assert(echo.call(runtime, true).getBool() == true);
+}